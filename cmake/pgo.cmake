@@ -0,0 +1,47 @@
+# AUTOGENERATED COPYRIGHT HEADER START
+# Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+# AUTOGENERATED COPYRIGHT HEADER END
+
+# Helper for the 'PGO-Train' target, run with 'cmake -P'.
+#
+# PGO_STEP=clean  Remove raw profiles from earlier training runs, keeping MSVC's .pgd databases.
+# PGO_STEP=merge  Merge raw profiles into what USE builds read, with PGO_MERGE_TOOL (llvm-profdata or pgomgr).
+
+if(NOT PGO_PROFILE_DIR)
+	message(FATAL_ERROR "PGO_PROFILE_DIR is not set.")
+endif()
+
+if(PGO_STEP STREQUAL "clean")
+	file(GLOB_RECURSE _stale "${PGO_PROFILE_DIR}/*.gcda" "${PGO_PROFILE_DIR}/*.profraw" "${PGO_PROFILE_DIR}/*.profdata" "${PGO_PROFILE_DIR}/*.pgc")
+	if(_stale)
+		file(REMOVE ${_stale})
+	endif()
+	file(MAKE_DIRECTORY "${PGO_PROFILE_DIR}")
+elseif(PGO_STEP STREQUAL "merge")
+	file(GLOB_RECURSE _gcda "${PGO_PROFILE_DIR}/*.gcda")
+	file(GLOB _profraw "${PGO_PROFILE_DIR}/*.profraw")
+	file(GLOB _pgd "${PGO_PROFILE_DIR}/*.pgd")
+
+	if(_profraw)
+		# Clang: one raw profile per instrumented module, merged into a single file.
+		execute_process(
+			COMMAND "${PGO_MERGE_TOOL}" merge "-output=${PGO_PROFILE_DIR}/default.profdata" ${_profraw}
+			COMMAND_ERROR_IS_FATAL ANY
+		)
+	elseif(_pgd)
+		# MSVC: every instrumented binary has its own database, merge the runs recorded next to it.
+		foreach(_database ${_pgd})
+			execute_process(
+				COMMAND "${PGO_MERGE_TOOL}" /merge "${_database}"
+				COMMAND_ERROR_IS_FATAL ANY
+			)
+		endforeach()
+	elseif(NOT _gcda)
+		# GCC updates its profiles in place, so there is nothing to merge, but there must be something.
+		message(FATAL_ERROR "No profiles were written to '${PGO_PROFILE_DIR}', was the build configured with ENABLE_PGO=GENERATE and built as Release?")
+	endif()
+
+	message(STATUS "Profiles are ready in '${PGO_PROFILE_DIR}', reconfigure with ENABLE_PGO=USE and rebuild.")
+else()
+	message(FATAL_ERROR "Unknown PGO_STEP '${PGO_STEP}'.")
+endif()
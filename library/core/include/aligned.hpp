@@ -0,0 +1,54 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#pragma once
+#include "warning-disable.hpp"
+#include <cstddef>
+#include <new>
+#include <vector>
+#include "warning-enable.hpp"
+
+namespace tonplugins::memory {
+	/// Alignment used for all sample buffers, enough for any vector unit and to avoid false sharing of cache lines.
+	constexpr size_t default_alignment = 64;
+
+	/** Allocator which aligns every allocation to a fixed boundary.
+	 */
+	template<typename T, size_t Alignment = default_alignment>
+	class aligned_allocator {
+		static_assert((Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two.");
+
+		public:
+		typedef T value_type;
+
+		template<typename U>
+		struct rebind {
+			typedef aligned_allocator<U, Alignment> other;
+		};
+
+		aligned_allocator() noexcept = default;
+		template<typename U>
+		aligned_allocator(aligned_allocator<U, Alignment> const&) noexcept
+		{}
+
+		T* allocate(size_t elements)
+		{
+			return static_cast<T*>(::operator new(elements * sizeof(T), std::align_val_t{Alignment}));
+		}
+
+		void deallocate(T* ptr, size_t) noexcept
+		{
+			::operator delete(ptr, std::align_val_t{Alignment});
+		}
+
+		template<typename U>
+		bool operator==(aligned_allocator<U, Alignment> const&) const noexcept
+		{
+			return true;
+		}
+	};
+
+	template<typename T, size_t Alignment = default_alignment>
+	using aligned_vector = std::vector<T, aligned_allocator<T, Alignment>>;
+} // namespace tonplugins::memory
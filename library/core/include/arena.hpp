@@ -0,0 +1,63 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#pragma once
+#include "aligned.hpp"
+
+#include "warning-disable.hpp"
+#include <cinttypes>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+#include "warning-enable.hpp"
+
+namespace tonplugins::memory {
+
+	/** Per-instance bump allocator for scratch and state buffers.
+	 *
+	 * Allocations are carved out of a few large blocks, each aligned to default_alignment, so all buffers of one
+	 * processor end up next to each other in memory instead of scattered across the heap. Memory is only given back
+	 * when the arena is cleared or destroyed. Allocate everything up front, never from the audio thread.
+	 */
+	class arena {
+		size_t                               _block_size;
+		size_t                               _used;
+		std::vector<aligned_vector<uint8_t>> _blocks;
+
+		public:
+		/** Create a new arena.
+		 *
+		 * @argument block_size Size of each block in bytes, larger allocations get a block of their own.
+		 */
+		arena(size_t block_size = 65536);
+		~arena();
+
+		arena(arena const&)            = delete;
+		arena& operator=(arena const&) = delete;
+
+		/** Allocate zero-initialized memory, aligned to default_alignment.
+		 */
+		void* allocate(size_t bytes);
+
+		template<typename T>
+		T* allocate(size_t elements)
+		{
+			static_assert(std::is_trivially_copyable_v<T>, "Arenas never run constructors or destructors.");
+			return static_cast<T*>(allocate(elements * sizeof(T)));
+		}
+
+		/** Total memory held by the arena in bytes.
+		 */
+		size_t capacity() const;
+
+		/** Zero the contents of every allocation, keeping all of them valid.
+		 */
+		void zero();
+
+		/** Release all memory, invalidating every allocation.
+		 */
+		void clear();
+	};
+
+} // namespace tonplugins::memory
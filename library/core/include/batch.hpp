@@ -0,0 +1,194 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#pragma once
+#include "warning-disable.hpp"
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "warning-enable.hpp"
+
+namespace tonplugins::batch {
+
+	/** Inference engine that processes many frames in one call.
+	 *
+	 * Frames are stored contiguously, one after another, so a batch is simply a matrix of batch × input_size() values.
+	 */
+	class backend {
+		public:
+		virtual ~backend();
+
+		/** Number of values in one input frame.
+		 */
+		virtual size_t input_size() const = 0;
+
+		/** Number of values in one output frame.
+		 */
+		virtual size_t output_size() const = 0;
+
+		/** Largest number of frames accepted by run().
+		 */
+		virtual size_t max_batch() const = 0;
+
+		/** Process a batch of frames.
+		 *
+		 * @argument input batch × input_size() values.
+		 * @argument output Receives batch × output_size() values.
+		 * @argument batch Number of frames, at most max_batch().
+		 */
+		virtual void run(float const* input, float* output, size_t batch) = 0;
+	};
+
+	/** Deterministic CPU backend, a single dense layer with tanh activation and fixed pseudo-random weights.
+	 *
+	 * Produces the exact same output for the same input regardless of how frames are batched, which makes it suitable
+	 * as a reference when testing the scheduler or comparing other backends.
+	 */
+	class reference_backend : public backend {
+		size_t _input_size;
+		size_t _output_size;
+		size_t _max_batch;
+
+		std::vector<float> _weights;
+		std::vector<float> _bias;
+
+		public:
+		reference_backend(size_t input_size, size_t output_size, size_t max_batch = 32, uint32_t seed = 1);
+		~reference_backend() override;
+
+		size_t input_size() const override;
+		size_t output_size() const override;
+		size_t max_batch() const override;
+		void   run(float const* input, float* output, size_t batch) override;
+	};
+
+	/** Groups frames submitted by many plugin instances into batched backend calls.
+	 *
+	 * Every instance connects as a client, and submits one fixed-size frame at a time together with the deadline by
+	 * which it needs the result. A worker thread collects submitted frames, waits briefly for more instances to catch
+	 * up as long as the earliest deadline allows it, runs them through the backend in one call and scatters the results
+	 * back. Submitting and collecting are lock-free and never block the audio thread: each client owns a preallocated
+	 * slot with an atomic state, and the worker sleeps on an atomic wait until woken by a submission. Waking it may cost
+	 * a system call in submit(), such as a futex wake on Linux, so submit() is not strictly wait-free.
+	 *
+	 * Use get() to share one scheduler for the same model between all instances in the process.
+	 */
+	class scheduler : public std::enable_shared_from_this<scheduler> {
+		public:
+		typedef std::chrono::steady_clock clock;
+
+		private:
+		enum state : uint32_t {
+			idle,
+			submitted,
+			running,
+			done,
+		};
+
+		struct alignas(64) slot {
+			std::atomic_bool      in_use = false;
+			std::atomic<uint32_t> status = idle;
+			std::atomic<int64_t>  deadline = 0;
+			std::vector<float>    input;
+			std::vector<float>    output;
+		};
+
+		std::shared_ptr<tonplugins::batch::backend> _backend;
+
+		size_t                  _max_clients;
+		std::unique_ptr<slot[]> _slots;
+		std::atomic_size_t      _clients;
+
+		// Only used by the worker.
+		std::vector<size_t> _batch_slots;
+		std::vector<float>  _batch_input;
+		std::vector<float>  _batch_output;
+		double              _cost;
+
+		std::atomic<uint32_t> _signal;
+		std::atomic_bool      _running;
+		std::atomic_uint64_t  _batches;
+		std::atomic_uint64_t  _frames;
+		std::thread           _worker;
+
+		public:
+		class client {
+			std::shared_ptr<scheduler> _scheduler;
+			slot*                      _slot;
+
+			public:
+			client(std::shared_ptr<scheduler> parent, slot* owned);
+			~client();
+
+			/** Submit a frame for processing.
+			 *
+			 * Never blocks, but wakes the worker thread through std::atomic::notify_one(), which may enter the kernel.
+			 *
+			 * @argument input input_size() values, copied into the client's slot.
+			 * @argument deadline Point in time by which the result is needed.
+			 * @return false if the previous frame hasn't been collected yet.
+			 */
+			bool submit(float const* input, clock::time_point deadline);
+
+			/** Collect the result of the submitted frame, if it is ready.
+			 *
+			 * @argument output Receives output_size() values.
+			 * @return true if the result was ready and has been copied.
+			 */
+			bool poll(float* output);
+
+			/** Wait for the result of the submitted frame, by spinning until it is ready or the deadline has passed.
+			 *
+			 * @argument output Receives output_size() values.
+			 * @return true if the result was ready and has been copied.
+			 */
+			bool wait(float* output, clock::time_point deadline);
+
+			/** Is a frame still waiting for or being processed?
+			 */
+			bool busy() const;
+		};
+
+		/** Create a new scheduler with its own worker thread.
+		 *
+		 * @argument engine The backend to run batches with.
+		 * @argument max_clients Largest number of clients that can be connected at the same time.
+		 */
+		scheduler(std::shared_ptr<tonplugins::batch::backend> engine, size_t max_clients = 64);
+		~scheduler();
+
+		tonplugins::batch::backend& engine();
+
+		/** Connect a new client.
+		 *
+		 * @return The client, which disconnects when destroyed.
+		 */
+		std::unique_ptr<client> connect();
+
+		/** Number of batches run so far.
+		 */
+		uint64_t batches() const;
+
+		/** Number of frames processed so far, frames() / batches() is the average batch size.
+		 */
+		uint64_t frames() const;
+
+		private:
+		void worker();
+
+		public:
+		/** Retrieve the scheduler shared by all instances under the given name, or create it.
+		 *
+		 * @argument name Identifies the model, for example its file name.
+		 * @argument factory Creates the backend if no scheduler exists yet.
+		 */
+		static std::shared_ptr<scheduler> get(std::string_view name, std::function<std::shared_ptr<tonplugins::batch::backend>()> factory, size_t max_clients = 64);
+	};
+
+} // namespace tonplugins::batch
@@ -0,0 +1,183 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#pragma once
+#include "aligned.hpp"
+
+#include "warning-disable.hpp"
+#include <cinttypes>
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include "warning-enable.hpp"
+
+namespace tonplugins::storage {
+
+	/** Build a chunk or content identifier from four characters, for example fourcc("STAT").
+	 */
+	constexpr uint32_t fourcc(char const (&code)[5])
+	{
+		return static_cast<uint32_t>(static_cast<uint8_t>(code[0])) | (static_cast<uint32_t>(static_cast<uint8_t>(code[1])) << 8) | (static_cast<uint32_t>(static_cast<uint8_t>(code[2])) << 16) | (static_cast<uint32_t>(static_cast<uint8_t>(code[3])) << 24);
+	}
+
+	/** Versioned binary container of named chunks, laid out so it can be used straight from memory.
+	 *
+	 * A fixed header identifies the format, the kind of content and the content's own version, and points at an index
+	 * of chunks. Every chunk starts on a 64 byte boundary, so arrays of samples or weights can be used in place by SIMD
+	 * code, and looking up a chunk never touches the data of any other chunk. All values are little-endian.
+	 *
+	 * Files are memory-mapped instead of read, so opening a large state or preset is nearly free and only the chunks
+	 * actually used are ever paged in. Memory that already holds a container, such as a state blob handed over by the
+	 * host, can be used the same way without copying it first.
+	 */
+	class container {
+		public:
+		static constexpr uint32_t magic     = 0x43425054; // "TPBC"
+		static constexpr uint32_t version   = 1;
+		static constexpr size_t   alignment = tonplugins::memory::default_alignment;
+
+		struct header {
+			uint32_t magic;
+			uint16_t version;
+			uint16_t header_size;
+			uint32_t type; // What is stored, as a fourcc.
+			uint32_t type_version; // Version of what is stored, up to its owner.
+			uint64_t index_offset;
+			uint64_t size; // Of the whole container, including the index.
+			uint32_t count; // Number of chunks in the index.
+			uint32_t reserved[7];
+		};
+		static_assert(sizeof(header) == alignment);
+
+		struct chunk {
+			uint32_t id; // As a fourcc.
+			uint32_t reserved;
+			uint64_t offset;
+			uint64_t size;
+		};
+
+		private:
+		std::shared_ptr<void const> _owner;
+		uint8_t const*              _data;
+		size_t                      _size;
+		header const*               _header;
+		chunk const*                _index;
+
+		public:
+		/** Memory-map a container file.
+		 *
+		 * @argument file File to map.
+		 */
+		container(std::filesystem::path const& file);
+
+		/** Use a container that is already in memory, without copying it.
+		 *
+		 * Memory that isn't aligned to a 64 byte boundary is copied once, so chunks are always aligned.
+		 *
+		 * @argument data Start of the container, must stay valid for the lifetime of this object.
+		 * @argument size Number of bytes available.
+		 */
+		container(void const* data, size_t size);
+		~container();
+
+		/** What is stored in the container, as given to the writer.
+		 */
+		uint32_t type() const;
+
+		/** Version of what is stored in the container, as given to the writer.
+		 */
+		uint32_t type_version() const;
+
+		/** Identifiers of all chunks, in the order they were added.
+		 */
+		std::vector<uint32_t> chunks() const;
+
+		bool contains(uint32_t id) const;
+
+		/** Contents of a chunk.
+		 *
+		 * @argument id Chunk to look up.
+		 * @return Contents of the chunk, or an empty span if there is no such chunk.
+		 */
+		std::span<uint8_t const> get(uint32_t id) const;
+
+		/** Contents of a chunk, as an array of trivially copyable values.
+		 *
+		 * @argument id Chunk to look up.
+		 * @return Contents of the chunk, or an empty span if there is no such chunk.
+		 * @throws std::runtime_error if the chunk is not a whole number of values.
+		 */
+		template<typename T>
+		std::span<T const> get_as(uint32_t id) const
+		{
+			static_assert(std::is_trivially_copyable_v<T> && (alignof(T) <= alignment));
+			auto bytes = get(id);
+			if ((bytes.size() % sizeof(T)) != 0) {
+				throw std::runtime_error("Chunk size is not a multiple of the requested type.");
+			}
+			return {reinterpret_cast<T const*>(bytes.data()), bytes.size() / sizeof(T)};
+		}
+
+		private:
+		void validate();
+	};
+
+	/** Builds a container in memory, and writes it out as a whole.
+	 */
+	class container_writer {
+		struct entry {
+			uint32_t             id;
+			std::vector<uint8_t> data;
+		};
+
+		uint32_t           _type;
+		uint32_t           _type_version;
+		std::vector<entry> _chunks;
+
+		public:
+		/** Start a new container.
+		 *
+		 * @argument type What will be stored, as a fourcc.
+		 * @argument type_version Version of what will be stored, up to the caller.
+		 */
+		container_writer(uint32_t type, uint32_t type_version);
+		~container_writer();
+
+		/** Add or replace a chunk, copying its contents.
+		 *
+		 * @argument id Identifier of the chunk, as a fourcc.
+		 * @argument data Contents of the chunk.
+		 * @argument size Size of the contents in bytes.
+		 */
+		void set(uint32_t id, void const* data, size_t size);
+
+		template<typename T>
+		void set(uint32_t id, std::span<T const> data)
+		{
+			static_assert(std::is_trivially_copyable_v<T>);
+			set(id, data.data(), data.size_bytes());
+		}
+
+		/** Lay out the whole container.
+		 *
+		 * @return The container, ready to be handed to a host or read back with container(data, size).
+		 */
+		tonplugins::memory::aligned_vector<uint8_t> build() const;
+
+		/** Write the container to a file.
+		 *
+		 * The file is replaced atomically and flushed to the storage device, so readers only ever see the old or the new
+		 * container, even after a crash or power loss. See platform::replace_file().
+		 *
+		 * @argument file File to write.
+		 */
+		void save(std::filesystem::path const& file) const;
+	};
+
+} // namespace tonplugins::storage
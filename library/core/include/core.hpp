@@ -7,6 +7,9 @@
 #include "warning-disable.hpp"
 #include <filesystem>
 #include <fstream>
+#include <functional>
+#include <future>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -68,17 +71,28 @@
 
 namespace tonplugins {
 	class core {
-		std::string           _app_name;
+		std::string _app_name;
+
+		// Nothing touches the file system until it is actually needed, so hosts can load modules to scan them cheaply.
+		std::once_flag        _paths_once;
 		std::filesystem::path _local_data;
 		std::filesystem::path _roaming_data;
 		std::filesystem::path _cache_data;
 
-		std::ofstream _log_stream;
-		std::mutex    _log_stream_mutex;
+		std::once_flag _log_once;
+		std::ofstream  _log_stream;
+		std::mutex     _log_stream_mutex;
 
 		private:
 		core(std::string app_name);
 
+		void initialize_paths();
+		void initialize_log();
+		void log_startup();
+
+		std::shared_ptr<void>                     find_cached(std::string_view key, std::function<std::shared_ptr<void>()> const& factory);
+		std::shared_future<std::shared_ptr<void>> find_preload(std::string_view key);
+
 		public:
 		~core();
 
@@ -98,6 +112,73 @@ namespace tonplugins {
 		public:
 		void log(std::string_view format, ...);
 
+		public /* Shared Resources */:
+		/** Retrieve a resource shared by all instances in the process, or create it if nobody holds it anymore.
+		 *
+		 * Only weak references are kept, so the resource is destroyed once the last user releases it. The cache belongs
+		 * to the process rather than to this core, so resources are shared even if nobody keeps a core alive. The key
+		 * must be unique for the type of resource, for example "tonplugins::dsp::fft<float>/1024".
+		 *
+		 * @argument key Unique identifier for the resource.
+		 * @argument factory Called (while holding the cache lock) to create the resource if it doesn't exist. It may
+		 *                   itself retrieve other cached resources, for example an FFT plan to design a filter with.
+		 * @return The shared resource.
+		 */
+		template<typename T>
+		std::shared_ptr<T> cached(std::string_view key, std::function<std::shared_ptr<T>()> factory)
+		{
+			return std::static_pointer_cast<T>(find_cached(key, [&factory]() -> std::shared_ptr<void> { return factory(); }));
+		}
+
+		public /* Preloading */:
+		/** Start creating a resource on a background thread, so that it is ready by the time an instance needs it.
+		 *
+		 * Meant to be called as soon as the module is opened, for anything that would otherwise hold up the first
+		 * instantiation, such as large libraries or model files. How long each load took is logged. Unlike cached(), the
+		 * result is kept alive for the lifetime of the process (or module), not just as long as this core exists, so a
+		 * plain core::instance()->preload() neither blocks nor loses the result. Loads still running when the module is
+		 * unloaded are waited for.
+		 *
+		 * @argument key Unique identifier for the resource, preloading the same key again returns the existing future.
+		 * @argument factory Called on a background thread to create the resource.
+		 * @return Future that becomes ready once the resource exists, and rethrows anything the factory threw.
+		 */
+		std::shared_future<std::shared_ptr<void>> preload(std::string_view key, std::function<std::shared_ptr<void>()> factory);
+
+		/** Start loading a dynamic library in the background.
+		 *
+		 * Uses the key "tonplugins::platform::library/" followed by the path. Later calls to platform::library::load()
+		 * with the same path share the loaded library.
+		 */
+		std::shared_future<std::shared_ptr<void>> preload_library(std::filesystem::path const& file);
+
+		/** Start mapping a file and paging all of it into memory in the background.
+		 *
+		 * Uses the key "tonplugins::platform::mapped_file/" followed by the path.
+		 */
+		std::shared_future<std::shared_ptr<void>> preload_file(std::filesystem::path const& file);
+
+		/** Check if a preloaded resource is ready, without waiting for it.
+		 *
+		 * @return true if the load has finished, successfully or not, false if it is still running or was never started.
+		 */
+		bool is_preloaded(std::string_view key);
+
+		/** Retrieve a preloaded resource, waiting for it if it is still being loaded.
+		 *
+		 * @return The resource, or nullptr if it was never preloaded.
+		 * @throws Anything the factory threw.
+		 */
+		template<typename T>
+		std::shared_ptr<T> preloaded(std::string_view key)
+		{
+			auto future = find_preload(key);
+			if (!future.valid()) {
+				return nullptr;
+			}
+			return std::static_pointer_cast<T>(future.get());
+		}
+
 		public:
 		static std::shared_ptr<tonplugins::core> instance(std::string app_name = "");
 	};
@@ -0,0 +1,78 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#pragma once
+#include "ringbuffer.hpp"
+
+#include "warning-disable.hpp"
+#include <cstddef>
+#include <vector>
+#include "warning-enable.hpp"
+
+namespace tonplugins::memory {
+
+	/** Adaptive-rate reader for ring buffers that are written from a different clock domain.
+	 *
+	 * Two clocks never run at exactly the same rate, so a ring buffer between them slowly fills up or drains until it
+	 * overruns or underruns. This reader keeps the fill level steady instead: it tracks a smoothed fill level, and a PI
+	 * controller adjusts the rate at which input is consumed by a tiny amount, resampling with cubic Hermite
+	 * interpolation. The correction is limited to max_deviation, which is far below anything audible.
+	 *
+	 * Until the rings have been filled up to the target, and after an underrun, the reader outputs silence and waits for
+	 * the target fill level to be reached again, instead of playing back fragments.
+	 */
+	template<typename T>
+	class drift_reader {
+		size_t _channels;
+		size_t _target;
+		double _max_deviation;
+
+		bool   _running;
+		double _fill;
+		double _integral;
+		double _ratio;
+		double _fraction;
+
+		// Last consumed sample of each channel, needed as the left neighbour for interpolation.
+		std::vector<T>        _history;
+		std::vector<T const*> _sources;
+
+		public:
+		/** Create a new drift compensating reader.
+		 *
+		 * @argument channels Number of channels, each read from its own ring buffer.
+		 * @argument target Fill level to hold, in samples. The rings should be able to hold at least twice this.
+		 * @argument max_deviation Largest allowed deviation from a ratio of 1, for example 0.001 for 1000 ppm.
+		 */
+		drift_reader(size_t channels, size_t target, double max_deviation = 0.001);
+		~drift_reader();
+
+		/** Fill level that is held steady, in samples.
+		 */
+		size_t target() const;
+		void   set_target(size_t target);
+
+		/** Smoothed fill level of the rings, in samples.
+		 */
+		double fill() const;
+
+		/** Current ratio of consumed input samples per output sample.
+		 */
+		double ratio() const;
+
+		/** Restart from silence, and wait for the target fill level to be reached again.
+		 */
+		void reset();
+
+		/** Read exactly the requested number of samples from a set of ring buffers.
+		 *
+		 * @argument rings Ring buffer for each channel, all written to in lock-step.
+		 * @argument output Pointers to each output channel.
+		 * @argument samples Number of samples to produce.
+		 * @return Number of samples that were produced from input, the rest is silence.
+		 */
+		size_t read(tonplugins::memory::ring<T>* const* rings, T* const* output, size_t samples);
+	};
+
+} // namespace tonplugins::memory
@@ -0,0 +1,164 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#pragma once
+#include "warning-disable.hpp"
+#include <atomic>
+#include <cinttypes>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include "warning-enable.hpp"
+
+namespace tonplugins::memory {
+
+	/** Lock-free exchange of shared state between writer threads and a single reader thread.
+	 *
+	 * Implemented as a triple buffer of owned snapshots: the writer fills the back slot, publishes it with a single
+	 * atomic exchange, and the reader picks up the newest published slot with another single atomic exchange. The
+	 * reader never blocks, never allocates and never frees memory, so it is safe to call acquire() from process().
+	 *
+	 * Snapshots which were superseded before the reader saw them, or which the reader has moved past, are handed
+	 * back to the writer side and destroyed there, keeping deallocation off the audio thread.
+	 *
+	 * Multiple writers (UI, host, worker threads) are serialized against each other with a mutex which the reader
+	 * never touches.
+	 */
+	template<typename T>
+	class exchange {
+		static constexpr uint32_t slot_mask = 0b011;
+		static constexpr uint32_t dirty_bit = 0b100;
+
+		std::unique_ptr<T> _slots[3];
+
+		alignas(64) std::atomic_uint32_t _middle;
+		alignas(64) uint32_t _front; // Owned by the reader.
+		alignas(64) uint32_t _back; // Owned by the writer.
+		std::mutex _writer_lock;
+
+		public:
+		exchange(std::unique_ptr<T> initial = nullptr) : _middle(1), _front(0), _back(2)
+		{
+			_slots[0] = std::move(initial);
+		}
+		~exchange() = default;
+
+		exchange(exchange const&)            = delete;
+		exchange& operator=(exchange const&) = delete;
+
+		public /* Writer */:
+		/** Publish a new snapshot for the reader.
+		 *
+		 * Any snapshot which the reader can no longer observe is destroyed before this returns.
+		 *
+		 * @argument value The new snapshot, ownership is transferred to the exchange.
+		 */
+		void publish(std::unique_ptr<T> value)
+		{
+			std::lock_guard<std::mutex> lock(_writer_lock);
+
+			// The back slot is exclusively ours, fill it and hand it over in a single step.
+			_slots[_back]  = std::move(value);
+			uint32_t stale = _middle.exchange(_back | dirty_bit, std::memory_order_acq_rel);
+
+			// Whatever we got back was either never read, or was released by the reader. Reclaim it here.
+			_back = stale & slot_mask;
+			_slots[_back].reset();
+		}
+
+		/** Construct and publish a new snapshot in place.
+		 */
+		template<typename... Args>
+		void emplace(Args&&... args)
+		{
+			publish(std::make_unique<T>(std::forward<Args>(args)...));
+		}
+
+		public /* Reader */:
+		/** Retrieve the latest published snapshot.
+		 *
+		 * Wait-free, and only to be called from a single thread. The returned pointer remains valid until the next call
+		 * to acquire() on the same thread.
+		 *
+		 * @return The most recently published snapshot, or the previous one if nothing new was published.
+		 */
+		T* acquire()
+		{
+			if (_middle.load(std::memory_order_relaxed) & dirty_bit) {
+				_front = _middle.exchange(_front, std::memory_order_acq_rel) & slot_mask;
+			}
+			return _slots[_front].get();
+		}
+
+		/** Check if a snapshot was published which the reader has not yet acquired.
+		 */
+		bool pending() const
+		{
+			return (_middle.load(std::memory_order_acquire) & dirty_bit) != 0;
+		}
+	};
+
+	/** Lock-free triple buffer of values between a single writer and a single reader thread.
+	 *
+	 * The counterpart to exchange<T> for when the audio thread is the one publishing, for example meter or scope data
+	 * for the editor. All three values are allocated up front, so neither side ever allocates, blocks or frees memory.
+	 */
+	template<typename T>
+	class triple_buffer {
+		static constexpr uint32_t slot_mask = 0b011;
+		static constexpr uint32_t dirty_bit = 0b100;
+
+		T _slots[3];
+
+		alignas(64) std::atomic_uint32_t _middle;
+		alignas(64) uint32_t _front; // Owned by the reader.
+		alignas(64) uint32_t _back; // Owned by the writer.
+
+		public:
+		triple_buffer(T const& initial = T{}) : _slots{initial, initial, initial}, _middle(1), _front(0), _back(2) {}
+		~triple_buffer() = default;
+
+		triple_buffer(triple_buffer const&)            = delete;
+		triple_buffer& operator=(triple_buffer const&) = delete;
+
+		public /* Writer */:
+		/** The value which will be published next, only valid on the writer thread.
+		 */
+		T& back()
+		{
+			return _slots[_back];
+		}
+
+		/** Publish the back value, and continue with the next free slot.
+		 *
+		 * The new back value holds whatever was last stored in it, not a copy of what was just published.
+		 */
+		void publish()
+		{
+			_back = _middle.exchange(_back | dirty_bit, std::memory_order_acq_rel) & slot_mask;
+		}
+
+		public /* Reader */:
+		/** Pick up the latest published value, if there is one.
+		 *
+		 * @return true if front() changed since the last call.
+		 */
+		bool poll()
+		{
+			if (!(_middle.load(std::memory_order_relaxed) & dirty_bit)) {
+				return false;
+			}
+			_front = _middle.exchange(_front, std::memory_order_acq_rel) & slot_mask;
+			return true;
+		}
+
+		/** The last value picked up by poll(), only valid on the reader thread.
+		 */
+		T const& front() const
+		{
+			return _slots[_front];
+		}
+	};
+
+} // namespace tonplugins::memory
@@ -0,0 +1,102 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#pragma once
+#include "exchange.hpp"
+
+#include "warning-disable.hpp"
+#include <atomic>
+#include <cinttypes>
+#include <vector>
+#include "warning-enable.hpp"
+
+namespace tonplugins {
+
+	/** Peak, RMS and true-peak metering from the audio thread to the editor.
+	 *
+	 * process() accumulates per-channel summaries with SIMD kernels and only publishes a snapshot once per display
+	 * refresh period, through a lock-free triple buffer. The editor polls the latest snapshot from its timer, and
+	 * never blocks or slows down the audio thread. While no editor is attached the meter is inactive and process()
+	 * returns immediately.
+	 */
+	class meter {
+		public:
+		static constexpr size_t max_channels = 8;
+
+		struct snapshot {
+			/// Increases by one for every published snapshot.
+			uint64_t sequence = 0;
+			size_t   channels = 0;
+
+			/// Highest absolute sample value since the last snapshot (linear).
+			float peak[max_channels] = {};
+			/// Exponentially averaged RMS over the configured window (linear).
+			float rms[max_channels] = {};
+			/// Highest absolute inter-sample value since the last snapshot, estimated with 4x oversampling (linear).
+			float true_peak[max_channels] = {};
+		};
+
+		private:
+		struct channel {
+			float              peak;
+			float              sum_sq;
+			float              mean_sq;
+			float              true_peak;
+			std::vector<float> history;
+		};
+
+		size_t   _channels;
+		size_t   _period;
+		size_t   _position;
+		float    _rms_coefficient;
+		uint64_t _sequence;
+
+		std::vector<channel> _state;
+		std::vector<float>   _true_peak_coefficients;
+
+		std::atomic_bool                            _active;
+		tonplugins::memory::triple_buffer<snapshot> _snapshots;
+
+		public:
+		/** Create a new meter.
+		 *
+		 * @argument channels Number of channels to meter, at most max_channels.
+		 * @argument sample_rate Sample rate of the audio being metered.
+		 * @argument refresh_rate How often (in Hz) a new snapshot should be published.
+		 * @argument rms_window Integration time of the RMS measurement in seconds.
+		 */
+		meter(size_t channels, double sample_rate, double refresh_rate = 60., double rms_window = .3);
+		~meter();
+
+		public /* Audio Thread */:
+		/** Measure a block of audio.
+		 *
+		 * @argument data Pointers to each channel's samples, at least as many as given to the constructor.
+		 * @argument samples Number of samples in each channel.
+		 */
+		void process(float const* const* data, size_t samples);
+
+		/** Clear all accumulated state, for example after a sample rate change or transport jump.
+		 */
+		void reset();
+
+		public /* Editor */:
+		/** Start or stop measuring, usually tied to the editor being open.
+		 */
+		void set_active(bool active);
+		bool is_active() const;
+
+		/** Fetch the newest snapshot.
+		 *
+		 * @argument out Receives the snapshot if there is a new one.
+		 * @return true if a new snapshot was available, otherwise false and out remains unchanged.
+		 */
+		bool poll(snapshot& out);
+
+		private:
+		void measure(channel& state, float const* data, size_t samples);
+		void flush();
+	};
+
+} // namespace tonplugins
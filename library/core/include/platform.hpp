@@ -5,6 +5,7 @@
 
 #pragma once
 #include "warning-disable.hpp"
+#include <cstddef>
 #include <filesystem>
 #include <memory>
 #include <string>
@@ -21,11 +22,61 @@ namespace tonplugins::platform {
 
 		void* load_symbol(std::string_view name);
 
+		/** The native module handle, HMODULE on Windows and the dlopen() handle elsewhere.
+		 */
+		void* native_handle();
+
 		static std::shared_ptr<::tonplugins::platform::library> load(std::filesystem::path file);
 
 		static std::shared_ptr<::tonplugins::platform::library> load(std::string_view name);
 	};
 
+	/** Read-only memory mapping of a whole file.
+	 *
+	 * The contents are paged in on demand by the operating system, so opening even very large files is cheap and
+	 * nothing is copied. The mapping stays valid until the object is destroyed, and keeps its contents if the file is
+	 * replaced by renaming another one over it, which is how container_writer::save() writes. Modifying the file in place
+	 * shows up in the mapping, and truncating it makes accesses past the new end raise SIGBUS on POSIX systems.
+	 */
+	class mapped_file {
+		void*  _data;
+		size_t _size;
+#ifdef _WIN32
+		void* _mapping;
+#endif
+
+		public:
+		mapped_file(std::filesystem::path const& file);
+		~mapped_file();
+
+		mapped_file(mapped_file const&)            = delete;
+		mapped_file& operator=(mapped_file const&) = delete;
+
+		/** Start of the mapped file, nullptr for empty files.
+		 */
+		void const* data() const;
+
+		/** Size of the mapped file in bytes.
+		 */
+		size_t size() const;
+
+		/** Let the operating system drop a range from memory, for example after streaming through it once.
+		 *
+		 * The range stays readable and is paged in again if accessed. Only whole pages inside the range are released.
+		 */
+		void release(size_t offset, size_t length) const;
+	};
+
+	/** Replace a file with new contents, such that it holds either the old or the new contents even after a crash or
+	 * power loss.
+	 *
+	 * The data is written to "<file>.tmp" next to it, flushed to the storage device, then renamed over the file. If
+	 * the process dies part way through, only that temporary file is left behind, and the next replace overwrites it.
+	 *
+	 * @throws std::runtime_error if the file can't be written.
+	 */
+	void replace_file(std::filesystem::path const& file, void const* data, size_t size);
+
 #ifdef _WIN32
 	std::string  wide_to_utf8(std::wstring const& v);
 	std::wstring utf8_to_wide(std::string const& v);
@@ -0,0 +1,127 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#pragma once
+#include "aligned.hpp"
+#include "container.hpp"
+
+#include "warning-disable.hpp"
+#include <cinttypes>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "warning-enable.hpp"
+
+namespace tonplugins::storage {
+
+	/** Descriptive information stored in every preset, in its "META" chunk.
+	 */
+	struct preset_info {
+		std::string name;
+		std::string author;
+		std::string category;
+		std::string tags; // Separated by spaces.
+	};
+
+	/** Content type of preset containers. The content version is the plug-in's own state version.
+	 */
+	constexpr uint32_t preset_type = fourcc("TPPR");
+
+	/** Store preset information in a container that is being built.
+	 *
+	 * The remaining chunks, such as the state itself, are up to the plug-in.
+	 */
+	void write_preset_info(container_writer& writer, preset_info const& info);
+
+	/** Read preset information back from a container.
+	 *
+	 * @throws std::runtime_error if the container is not a preset, or the information is corrupted.
+	 */
+	preset_info read_preset_info(container const& preset);
+
+	/** Browsable and searchable index over a directory of presets.
+	 *
+	 * The index is a container of fixed-size records and a string pool, which is memory-mapped and used in place. So
+	 * listing and searching thousands of presets never opens a single preset file. refresh() only re-reads presets whose
+	 * size or modification time changed, and writes the updated index back out atomically. Presets that failed to read
+	 * are remembered as well, and only tried again once they change.
+	 *
+	 * Not thread-safe, and refresh() invalidates all previously returned views.
+	 */
+	class preset_library {
+		public:
+		static constexpr uint32_t index_type    = fourcc("TPPX");
+		static constexpr uint32_t index_version = 1;
+
+		/// File extension of presets.
+		static constexpr std::string_view extension = ".tpreset";
+
+		/** View of a preset in the index, valid until the next refresh().
+		 */
+		struct preset {
+			std::string_view file; // Relative to the preset directory, with '/' as separator.
+			std::string_view name;
+			std::string_view author;
+			std::string_view category;
+			std::string_view tags;
+		};
+
+		private:
+		struct record;
+
+		std::filesystem::path                       _directory;
+		std::filesystem::path                       _index_file;
+		std::unique_ptr<container>                  _index;
+		tonplugins::memory::aligned_vector<uint8_t> _memory; // Only used if the index can't be written.
+
+		public:
+		/** Open the preset library of the current plug-in.
+		 *
+		 * Presets live in "Presets" under core::roaming_data_path(), the index in core::cache_data_path().
+		 */
+		preset_library();
+
+		/** Open a preset library.
+		 *
+		 * The existing index is used as is if it can be read. Otherwise, or if there is none, the index is built right away.
+		 *
+		 * @argument directory Directory to search for presets, including all sub-directories.
+		 * @argument index_file Where to keep the index.
+		 */
+		preset_library(std::filesystem::path directory, std::filesystem::path index_file);
+		~preset_library();
+
+		std::filesystem::path const& directory() const;
+
+		/** Number of presets, ordered by category and then name.
+		 */
+		size_t size() const;
+
+		preset at(size_t index) const;
+
+		/** Find presets matching every term of the query.
+		 *
+		 * Terms are separated by spaces and matched case-insensitively against the name, author, category and tags.
+		 *
+		 * @argument query Terms to search for, an empty query matches everything.
+		 * @return Indices of the matching presets, in order.
+		 */
+		std::vector<size_t> search(std::string_view query) const;
+
+		/** Bring the index up to date with the preset directory.
+		 *
+		 * @return Number of preset files that had to be read.
+		 */
+		size_t refresh();
+
+		private:
+		std::span<record const> records() const;
+		std::span<record const> failures() const;
+		std::string_view        string(uint32_t offset, uint32_t length) const;
+	};
+
+} // namespace tonplugins::storage
@@ -0,0 +1,99 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#pragma once
+#include "ringbuffer.hpp"
+
+#include "warning-disable.hpp"
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include "warning-enable.hpp"
+
+namespace tonplugins::memory {
+
+	/** Re-frames host blocks of arbitrary and varying size into fixed-size frames for frame-based engines.
+	 *
+	 * Host input is accumulated in one ring buffer per channel. Whenever a full frame is available, the engine is
+	 * called with pointers straight into the mirrored ring memory, both for its input and for its output, so frames
+	 * are always contiguous and never copied. Output is then drained back into the host buffers.
+	 *
+	 * The output rings are primed with frame - 1 samples of silence, which is the least latency that works for every
+	 * possible sequence of host block sizes. Report latency() to the host, for example from getLatencySamples().
+	 */
+	template<typename T>
+	class reframer {
+		size_t _channels;
+		size_t _frame;
+		size_t _max_block;
+		size_t _engine_latency;
+
+		std::vector<std::unique_ptr<tonplugins::memory::ring<T>>> _input;
+		std::vector<std::unique_ptr<tonplugins::memory::ring<T>>> _output;
+		std::vector<T const*>                                     _sources;
+		std::vector<T*>                                           _targets;
+
+		public:
+		/** Create a new re-framer.
+		 *
+		 * @argument channels Number of channels.
+		 * @argument frame Frame size required by the engine.
+		 * @argument max_block Largest host block size, larger blocks are split up internally.
+		 * @argument engine_latency Latency added by the engine itself, included in latency().
+		 */
+		reframer(size_t channels, size_t frame, size_t max_block, size_t engine_latency = 0);
+		~reframer();
+
+		/** Frame size given to the engine.
+		 */
+		size_t frame() const;
+
+		/** Total latency in samples, including the engine's own latency.
+		 */
+		size_t latency() const;
+
+		/** Drop all buffered audio, and prime the output with silence again.
+		 */
+		void reset();
+
+		/** Process a host block.
+		 *
+		 * @argument input Pointers to each input channel.
+		 * @argument output Pointers to each output channel, may be the same as input.
+		 * @argument samples Number of samples in the block.
+		 * @argument engine Callable as engine(T const* const* input, T* const* output, size_t frame), called once for
+		 *                  every complete frame.
+		 */
+		template<typename Engine>
+		void process(T const* const* input, T* const* output, size_t samples, Engine&& engine)
+		{
+			for (size_t offset = 0; offset < samples; offset += _max_block) {
+				size_t length = std::min(_max_block, samples - offset);
+
+				for (size_t idx = 0; idx < _channels; idx++) {
+					_input[idx]->write(length, input[idx] + offset);
+				}
+
+				while (_input[0]->used() >= _frame) {
+					for (size_t idx = 0; idx < _channels; idx++) {
+						_sources[idx] = _input[idx]->peek(_frame);
+						_targets[idx] = _output[idx]->poke(_frame);
+					}
+
+					engine(_sources.data(), _targets.data(), _frame);
+
+					for (size_t idx = 0; idx < _channels; idx++) {
+						_input[idx]->read(_frame, nullptr);
+						_output[idx]->write(_frame, nullptr);
+					}
+				}
+
+				for (size_t idx = 0; idx < _channels; idx++) {
+					_output[idx]->read(length, output[idx] + offset);
+				}
+			}
+		}
+	};
+
+} // namespace tonplugins::memory
@@ -0,0 +1,103 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#pragma once
+#include "warning-disable.hpp"
+#include <chrono>
+#include <cinttypes>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include "warning-enable.hpp"
+
+namespace tonplugins::memory {
+
+	/** Named single-producer single-consumer ring buffer in memory shared between processes.
+	 *
+	 * Allows moving heavy or crash-prone engines into a separate helper process, while audio is exchanged through
+	 * shared memory instead of sockets or pipes. One side creates the ring by name, the other side opens it, and
+	 * exactly one of them writes while the other reads.
+	 *
+	 * The shared memory starts with a header holding a magic value, the layout version, the element size and capacity,
+	 * followed by the read and write positions on separate cache lines. Positions are 64-bit and only ever increase, so
+	 * a full ring is never confused with an empty one. Either side can block until data or space is available, which
+	 * uses a futex on Linux, named events on Windows, and short sleeps everywhere else.
+	 */
+	template<typename T>
+	class shared_ring {
+		struct header;
+
+		std::string _name;
+		bool        _owner;
+		header*     _header;
+		T*          _buffer;
+		size_t      _size;
+
+		std::shared_ptr<void> _internal_data;
+
+		public:
+		static constexpr uint32_t magic   = 0x52535054; // "TPSR"
+		static constexpr uint32_t version = 1;
+
+		/** Create or open a named ring buffer.
+		 *
+		 * @argument name Name shared by both processes, without any path separators.
+		 * @argument elements Capacity in elements to create a new ring with. If zero, an existing ring is opened instead,
+		 *                    and its layout is verified.
+		 * @throws std::runtime_error if a ring can't be created or opened. When creating, a stale ring of the same name is
+		 *         unlinked and replaced on POSIX systems. Windows keeps it alive as long as any process still has it
+		 *         open, and then throws instead.
+		 */
+		shared_ring(std::string_view name, size_t elements = 0);
+		~shared_ring();
+
+		std::string_view name() const;
+
+		/** Capacity of the ring buffer in elements.
+		 */
+		size_t size() const;
+
+		/** Number of elements available for reading.
+		 */
+		size_t used() const;
+
+		/** Number of elements that can be written without overwriting unread data.
+		 */
+		size_t free() const;
+
+		/** Write data into the ring buffer, never overwriting unread data.
+		 *
+		 * Wakes up the reader if it is waiting.
+		 *
+		 * @argument size The size (in elements) of the data to write.
+		 * @argument buffer The buffer to copy data from.
+		 * @return The number of elements actually written, limited by free().
+		 */
+		size_t write(size_t size, T const* buffer);
+
+		/** Read data from the ring buffer.
+		 *
+		 * Wakes up the writer if it is waiting.
+		 *
+		 * @argument size The size (in elements) of the data to read.
+		 * @argument buffer The buffer to copy data into, or nullptr to skip data.
+		 * @return The number of elements actually read, limited by used().
+		 */
+		size_t read(size_t size, T* buffer);
+
+		/** Block until at least the given number of elements can be read.
+		 *
+		 * @return true if the data is available, false if the timeout expired first.
+		 */
+		bool wait_for_data(size_t size, std::chrono::microseconds timeout);
+
+		/** Block until at least the given number of elements can be written.
+		 *
+		 * @return true if the space is available, false if the timeout expired first.
+		 */
+		bool wait_for_space(size_t size, std::chrono::microseconds timeout);
+	};
+
+} // namespace tonplugins::memory
@@ -0,0 +1,90 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#pragma once
+#include "warning-disable.hpp"
+#include <cinttypes>
+#include <cstddef>
+#include <limits>
+#include "warning-enable.hpp"
+
+namespace tonplugins::silence {
+	/// Default threshold for silence detection, about -120 dBFS.
+	constexpr float default_threshold = 1e-6f;
+
+	/// Tail length for effects which never stop producing output on their own.
+	constexpr size_t infinite_tail = std::numeric_limits<size_t>::max();
+
+	/** Check if a block of samples is silent.
+	 *
+	 * Vectorized, and stops scanning at the first audible sample, so audible blocks cost almost nothing to check.
+	 *
+	 * @argument data The samples to check.
+	 * @argument samples Number of samples in data.
+	 * @argument threshold Largest absolute value still considered silent.
+	 * @return true if no sample exceeds the threshold.
+	 */
+	template<typename T>
+	bool is_silent(T const* data, size_t samples, T threshold = static_cast<T>(default_threshold));
+
+	/** Fill a block of channels with zeros.
+	 */
+	template<typename T>
+	void clear(T* const* data, size_t channels, size_t samples);
+
+	/** Tracks silent input and the remaining effect tail, to decide when process() may be skipped.
+	 *
+	 * Call update() at the start of each process() call with the input. If it returns false, the input has been silent
+	 * for longer than the effect's tail, and the plugin may skip its DSP entirely, clear() the output, and report
+	 * silence_flags() to the host. Any audible input re-arms the tail.
+	 */
+	class gate {
+		size_t _tail;
+		size_t _remaining;
+		float  _threshold;
+		bool   _silent;
+
+		public:
+		/** Create a new gate.
+		 *
+		 * @argument tail Number of samples the effect keeps producing output after its input went silent.
+		 * @argument threshold Largest absolute value still considered silent.
+		 */
+		gate(size_t tail = 0, float threshold = default_threshold);
+		~gate();
+
+		/** Change the tail length, for example when a parameter changes the decay time.
+		 */
+		void   set_tail(size_t tail);
+		size_t tail() const;
+
+		/** Forget about previous input and re-arm the tail, so at least the next tail() samples are processed.
+		 *
+		 * With no tail, silent input may be skipped right away.
+		 */
+		void reset();
+
+		/** Update the gate with the next block of input.
+		 *
+		 * @argument data Pointers to each input channel.
+		 * @argument channels Number of input channels.
+		 * @argument samples Number of samples in each channel.
+		 * @argument silence_flags Host provided silence flags for the input, with one bit per channel. Channels flagged as
+		 *                         silent by the host are not scanned.
+		 * @return true if the block needs to be processed, false if it can be skipped.
+		 */
+		template<typename T>
+		bool update(T const* const* data, size_t channels, size_t samples, uint64_t silence_flags = 0);
+
+		/** Is the output currently silent?
+		 */
+		bool is_silent() const;
+
+		/** Silence flags to report for an output with the given number of channels.
+		 *
+		 * @return A bit set for every channel if the output is silent, otherwise 0.
+		 */
+		uint64_t silence_flags(size_t channels) const;
+	};
+} // namespace tonplugins::silence
@@ -0,0 +1,401 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#pragma once
+#include "warning-disable.hpp"
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+#include <cstddef>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define TONPLUGINS_SIMD_SSE2
+#include <emmintrin.h>
+#if defined(__SSSE3__) || defined(__AVX__)
+#define TONPLUGINS_SIMD_SSSE3
+#include <tmmintrin.h>
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#define TONPLUGINS_SIMD_NEON
+#include <arm_neon.h>
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define TONPLUGINS_SIMD_NEON64
+#endif
+#endif
+#include "warning-enable.hpp"
+
+/* Thin portable wrappers around the vector units we actually ship for.
+ *
+ * Only what the DSP code needs is exposed here. Everything compiles down to plain intrinsics on SSE2 (x86, x86-64,
+ * ARM64EC) and NEON (ARM), and to scalar code elsewhere. All loads and stores are unaligned, which costs nothing on
+ * any of the supported targets when the data happens to be aligned.
+ */
+namespace tonplugins::simd {
+
+	/** Four packed single precision floats.
+	 */
+	struct f32x4 {
+		static constexpr size_t width = 4;
+		typedef float           scalar_t;
+
+#if defined(TONPLUGINS_SIMD_SSE2)
+		__m128 v;
+
+		static f32x4 load(float const* p)
+		{
+			return {_mm_loadu_ps(p)};
+		}
+		static f32x4 broadcast(float x)
+		{
+			return {_mm_set1_ps(x)};
+		}
+		static f32x4 zero()
+		{
+			return {_mm_setzero_ps()};
+		}
+		void store(float* p) const
+		{
+			_mm_storeu_ps(p, v);
+		}
+#elif defined(TONPLUGINS_SIMD_NEON)
+		float32x4_t v;
+
+		static f32x4 load(float const* p)
+		{
+			return {vld1q_f32(p)};
+		}
+		static f32x4 broadcast(float x)
+		{
+			return {vdupq_n_f32(x)};
+		}
+		static f32x4 zero()
+		{
+			return {vdupq_n_f32(0.f)};
+		}
+		void store(float* p) const
+		{
+			vst1q_f32(p, v);
+		}
+#else
+		float v[4];
+
+		static f32x4 load(float const* p)
+		{
+			return {{p[0], p[1], p[2], p[3]}};
+		}
+		static f32x4 broadcast(float x)
+		{
+			return {{x, x, x, x}};
+		}
+		static f32x4 zero()
+		{
+			return broadcast(0.f);
+		}
+		void store(float* p) const
+		{
+			p[0] = v[0], p[1] = v[1], p[2] = v[2], p[3] = v[3];
+		}
+#endif
+	};
+
+	/** Two packed double precision floats.
+	 */
+	struct f64x2 {
+		static constexpr size_t width = 2;
+		typedef double          scalar_t;
+
+#if defined(TONPLUGINS_SIMD_SSE2)
+		__m128d v;
+
+		static f64x2 load(double const* p)
+		{
+			return {_mm_loadu_pd(p)};
+		}
+		static f64x2 broadcast(double x)
+		{
+			return {_mm_set1_pd(x)};
+		}
+		static f64x2 zero()
+		{
+			return {_mm_setzero_pd()};
+		}
+		void store(double* p) const
+		{
+			_mm_storeu_pd(p, v);
+		}
+#elif defined(TONPLUGINS_SIMD_NEON64)
+		float64x2_t v;
+
+		static f64x2 load(double const* p)
+		{
+			return {vld1q_f64(p)};
+		}
+		static f64x2 broadcast(double x)
+		{
+			return {vdupq_n_f64(x)};
+		}
+		static f64x2 zero()
+		{
+			return {vdupq_n_f64(0.)};
+		}
+		void store(double* p) const
+		{
+			vst1q_f64(p, v);
+		}
+#else
+		double v[2];
+
+		static f64x2 load(double const* p)
+		{
+			return {{p[0], p[1]}};
+		}
+		static f64x2 broadcast(double x)
+		{
+			return {{x, x}};
+		}
+		static f64x2 zero()
+		{
+			return broadcast(0.);
+		}
+		void store(double* p) const
+		{
+			p[0] = v[0], p[1] = v[1];
+		}
+#endif
+	};
+
+#if defined(TONPLUGINS_SIMD_SSE2)
+	inline f32x4 operator+(f32x4 a, f32x4 b)
+	{
+		return {_mm_add_ps(a.v, b.v)};
+	}
+	inline f32x4 operator-(f32x4 a, f32x4 b)
+	{
+		return {_mm_sub_ps(a.v, b.v)};
+	}
+	inline f32x4 operator*(f32x4 a, f32x4 b)
+	{
+		return {_mm_mul_ps(a.v, b.v)};
+	}
+	inline f32x4 min(f32x4 a, f32x4 b)
+	{
+		return {_mm_min_ps(a.v, b.v)};
+	}
+	inline f32x4 max(f32x4 a, f32x4 b)
+	{
+		return {_mm_max_ps(a.v, b.v)};
+	}
+	inline f32x4 abs(f32x4 a)
+	{
+		return {_mm_andnot_ps(_mm_set1_ps(-0.f), a.v)};
+	}
+	inline float hsum(f32x4 a)
+	{
+		__m128 t = _mm_add_ps(a.v, _mm_movehl_ps(a.v, a.v));
+		t        = _mm_add_ss(t, _mm_shuffle_ps(t, t, 0x55));
+		return _mm_cvtss_f32(t);
+	}
+	inline float hmax(f32x4 a)
+	{
+		__m128 t = _mm_max_ps(a.v, _mm_movehl_ps(a.v, a.v));
+		t        = _mm_max_ss(t, _mm_shuffle_ps(t, t, 0x55));
+		return _mm_cvtss_f32(t);
+	}
+
+	inline f64x2 operator+(f64x2 a, f64x2 b)
+	{
+		return {_mm_add_pd(a.v, b.v)};
+	}
+	inline f64x2 operator-(f64x2 a, f64x2 b)
+	{
+		return {_mm_sub_pd(a.v, b.v)};
+	}
+	inline f64x2 operator*(f64x2 a, f64x2 b)
+	{
+		return {_mm_mul_pd(a.v, b.v)};
+	}
+	inline f64x2 min(f64x2 a, f64x2 b)
+	{
+		return {_mm_min_pd(a.v, b.v)};
+	}
+	inline f64x2 max(f64x2 a, f64x2 b)
+	{
+		return {_mm_max_pd(a.v, b.v)};
+	}
+	inline f64x2 abs(f64x2 a)
+	{
+		return {_mm_andnot_pd(_mm_set1_pd(-0.), a.v)};
+	}
+	inline double hsum(f64x2 a)
+	{
+		return _mm_cvtsd_f64(_mm_add_sd(a.v, _mm_unpackhi_pd(a.v, a.v)));
+	}
+	inline double hmax(f64x2 a)
+	{
+		return _mm_cvtsd_f64(_mm_max_sd(a.v, _mm_unpackhi_pd(a.v, a.v)));
+	}
+#elif defined(TONPLUGINS_SIMD_NEON)
+	inline f32x4 operator+(f32x4 a, f32x4 b)
+	{
+		return {vaddq_f32(a.v, b.v)};
+	}
+	inline f32x4 operator-(f32x4 a, f32x4 b)
+	{
+		return {vsubq_f32(a.v, b.v)};
+	}
+	inline f32x4 operator*(f32x4 a, f32x4 b)
+	{
+		return {vmulq_f32(a.v, b.v)};
+	}
+	inline f32x4 min(f32x4 a, f32x4 b)
+	{
+		return {vminq_f32(a.v, b.v)};
+	}
+	inline f32x4 max(f32x4 a, f32x4 b)
+	{
+		return {vmaxq_f32(a.v, b.v)};
+	}
+	inline f32x4 abs(f32x4 a)
+	{
+		return {vabsq_f32(a.v)};
+	}
+	inline float hsum(f32x4 a)
+	{
+		float32x2_t t = vadd_f32(vget_low_f32(a.v), vget_high_f32(a.v));
+		return vget_lane_f32(vpadd_f32(t, t), 0);
+	}
+	inline float hmax(f32x4 a)
+	{
+		float32x2_t t = vmax_f32(vget_low_f32(a.v), vget_high_f32(a.v));
+		return vget_lane_f32(vpmax_f32(t, t), 0);
+	}
+#else
+	inline f32x4 operator+(f32x4 a, f32x4 b)
+	{
+		return {{a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]}};
+	}
+	inline f32x4 operator-(f32x4 a, f32x4 b)
+	{
+		return {{a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3]}};
+	}
+	inline f32x4 operator*(f32x4 a, f32x4 b)
+	{
+		return {{a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]}};
+	}
+	inline f32x4 min(f32x4 a, f32x4 b)
+	{
+		return {{std::min(a.v[0], b.v[0]), std::min(a.v[1], b.v[1]), std::min(a.v[2], b.v[2]), std::min(a.v[3], b.v[3])}};
+	}
+	inline f32x4 max(f32x4 a, f32x4 b)
+	{
+		return {{std::max(a.v[0], b.v[0]), std::max(a.v[1], b.v[1]), std::max(a.v[2], b.v[2]), std::max(a.v[3], b.v[3])}};
+	}
+	inline f32x4 abs(f32x4 a)
+	{
+		return {{std::fabs(a.v[0]), std::fabs(a.v[1]), std::fabs(a.v[2]), std::fabs(a.v[3])}};
+	}
+	inline float hsum(f32x4 a)
+	{
+		return (a.v[0] + a.v[1]) + (a.v[2] + a.v[3]);
+	}
+	inline float hmax(f32x4 a)
+	{
+		return std::max(std::max(a.v[0], a.v[1]), std::max(a.v[2], a.v[3]));
+	}
+#endif
+
+#if defined(TONPLUGINS_SIMD_NEON64)
+	inline f64x2 operator+(f64x2 a, f64x2 b)
+	{
+		return {vaddq_f64(a.v, b.v)};
+	}
+	inline f64x2 operator-(f64x2 a, f64x2 b)
+	{
+		return {vsubq_f64(a.v, b.v)};
+	}
+	inline f64x2 operator*(f64x2 a, f64x2 b)
+	{
+		return {vmulq_f64(a.v, b.v)};
+	}
+	inline f64x2 min(f64x2 a, f64x2 b)
+	{
+		return {vminq_f64(a.v, b.v)};
+	}
+	inline f64x2 max(f64x2 a, f64x2 b)
+	{
+		return {vmaxq_f64(a.v, b.v)};
+	}
+	inline f64x2 abs(f64x2 a)
+	{
+		return {vabsq_f64(a.v)};
+	}
+	inline double hsum(f64x2 a)
+	{
+		return vaddvq_f64(a.v);
+	}
+	inline double hmax(f64x2 a)
+	{
+		return vmaxvq_f64(a.v);
+	}
+#elif !defined(TONPLUGINS_SIMD_SSE2)
+	inline f64x2 operator+(f64x2 a, f64x2 b)
+	{
+		return {{a.v[0] + b.v[0], a.v[1] + b.v[1]}};
+	}
+	inline f64x2 operator-(f64x2 a, f64x2 b)
+	{
+		return {{a.v[0] - b.v[0], a.v[1] - b.v[1]}};
+	}
+	inline f64x2 operator*(f64x2 a, f64x2 b)
+	{
+		return {{a.v[0] * b.v[0], a.v[1] * b.v[1]}};
+	}
+	inline f64x2 min(f64x2 a, f64x2 b)
+	{
+		return {{std::min(a.v[0], b.v[0]), std::min(a.v[1], b.v[1])}};
+	}
+	inline f64x2 max(f64x2 a, f64x2 b)
+	{
+		return {{std::max(a.v[0], b.v[0]), std::max(a.v[1], b.v[1])}};
+	}
+	inline f64x2 abs(f64x2 a)
+	{
+		return {{std::fabs(a.v[0]), std::fabs(a.v[1])}};
+	}
+	inline double hsum(f64x2 a)
+	{
+		return a.v[0] + a.v[1];
+	}
+	inline double hmax(f64x2 a)
+	{
+		return std::max(a.v[0], a.v[1]);
+	}
+#endif
+
+	/** Multiply-add, a * b + c.
+	 *
+	 * Left to the compiler so it can fuse it where the target allows.
+	 */
+	template<typename V>
+	inline V madd(V a, V b, V c)
+	{
+		return (a * b) + c;
+	}
+
+	/** The widest vector type available for a given scalar type.
+	 */
+	template<typename T>
+	struct native;
+	template<>
+	struct native<float> {
+		typedef f32x4 type;
+	};
+	template<>
+	struct native<double> {
+		typedef f64x2 type;
+	};
+	template<typename T>
+	using native_t = typename native<T>::type;
+
+} // namespace tonplugins::simd
@@ -0,0 +1,51 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#include "arena.hpp"
+
+#include "warning-disable.hpp"
+#include <algorithm>
+#include <cstring>
+#include "warning-enable.hpp"
+
+tonplugins::memory::arena::arena(size_t block_size) : _block_size(block_size), _used(0) {}
+
+tonplugins::memory::arena::~arena() = default;
+
+void* tonplugins::memory::arena::allocate(size_t bytes)
+{
+	// Keep every allocation on its own cache line, so neighbours never share one.
+	bytes = std::max<size_t>(((bytes + default_alignment - 1) / default_alignment) * default_alignment, default_alignment);
+
+	if (_blocks.empty() || ((_blocks.back().size() - _used) < bytes)) {
+		_blocks.emplace_back(std::max(_block_size, bytes), uint8_t(0));
+		_used = 0;
+	}
+
+	void* ptr = _blocks.back().data() + _used;
+	_used += bytes;
+	return ptr;
+}
+
+size_t tonplugins::memory::arena::capacity() const
+{
+	size_t total = 0;
+	for (auto const& block : _blocks) {
+		total += block.size();
+	}
+	return total;
+}
+
+void tonplugins::memory::arena::zero()
+{
+	for (auto& block : _blocks) {
+		memset(block.data(), 0, block.size());
+	}
+}
+
+void tonplugins::memory::arena::clear()
+{
+	_blocks.clear();
+	_used = 0;
+}
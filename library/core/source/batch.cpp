@@ -0,0 +1,285 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#include "batch.hpp"
+#include "core.hpp"
+#include "simd.hpp"
+
+#include "warning-disable.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include "warning-enable.hpp"
+
+// Longest time the worker holds back a batch to wait for more clients, regardless of deadlines.
+constexpr auto max_gather_time = std::chrono::microseconds(500);
+
+tonplugins::batch::backend::~backend() = default;
+
+tonplugins::batch::reference_backend::reference_backend(size_t input_size, size_t output_size, size_t max_batch, uint32_t seed) : _input_size(input_size), _output_size(output_size), _max_batch(max_batch)
+{
+	if ((input_size == 0) || (output_size == 0) || (max_batch == 0)) {
+		throw std::invalid_argument("Frame sizes and batch size must be non-zero.");
+	}
+
+	// Simple LCG, so the weights are identical on every platform and standard library.
+	uint32_t state = seed;
+	auto     next  = [&state]() {
+        state = state * 1664525u + 1013904223u;
+        return static_cast<float>(state >> 8) / static_cast<float>(1u << 24) * 2.f - 1.f;
+	};
+
+	float scale = 1.f / std::sqrt(static_cast<float>(_input_size));
+	_weights.resize(_output_size * _input_size);
+	for (auto& weight : _weights) {
+		weight = next() * scale;
+	}
+	_bias.resize(_output_size);
+	for (auto& bias : _bias) {
+		bias = next() * .1f;
+	}
+}
+
+tonplugins::batch::reference_backend::~reference_backend() = default;
+
+size_t tonplugins::batch::reference_backend::input_size() const
+{
+	return _input_size;
+}
+
+size_t tonplugins::batch::reference_backend::output_size() const
+{
+	return _output_size;
+}
+
+size_t tonplugins::batch::reference_backend::max_batch() const
+{
+	return _max_batch;
+}
+
+void tonplugins::batch::reference_backend::run(float const* input, float* output, size_t batch)
+{
+	typedef tonplugins::simd::f32x4 vec_t;
+	size_t vector_size = (_input_size / vec_t::width) * vec_t::width;
+
+	// Each row of weights is loaded once per batch instead of once per frame, which is where batching pays off.
+	for (size_t row = 0; row < _output_size; row++) {
+		float const* w = _weights.data() + row * _input_size;
+		for (size_t frame = 0; frame < batch; frame++) {
+			float const* x   = input + frame * _input_size;
+			vec_t        acc = vec_t::zero();
+			size_t       col = 0;
+			for (; col < vector_size; col += vec_t::width) {
+				acc = tonplugins::simd::madd(vec_t::load(w + col), vec_t::load(x + col), acc);
+			}
+			float sum = _bias[row] + tonplugins::simd::hsum(acc);
+			for (; col < _input_size; col++) {
+				sum += w[col] * x[col];
+			}
+			output[frame * _output_size + row] = std::tanh(sum);
+		}
+	}
+}
+
+tonplugins::batch::scheduler::client::client(std::shared_ptr<scheduler> parent, slot* owned) : _scheduler(parent), _slot(owned) {}
+
+tonplugins::batch::scheduler::client::~client()
+{
+	// Take back a frame the worker hasn't claimed yet, or wait for it to finish one that it has.
+	uint32_t expected = submitted;
+	_slot->status.compare_exchange_strong(expected, idle);
+	while (_slot->status.load() == running) {
+		_slot->status.wait(running);
+	}
+
+	_slot->status.store(idle);
+	_slot->in_use.store(false);
+	_scheduler->_clients.fetch_sub(1);
+}
+
+bool tonplugins::batch::scheduler::client::submit(float const* input, clock::time_point deadline)
+{
+	if (_slot->status.load(std::memory_order_acquire) != idle) {
+		return false;
+	}
+
+	memcpy(_slot->input.data(), input, _slot->input.size() * sizeof(float));
+	_slot->deadline.store(deadline.time_since_epoch().count(), std::memory_order_relaxed);
+	_slot->status.store(submitted, std::memory_order_release);
+
+	_scheduler->_signal.fetch_add(1, std::memory_order_release);
+	_scheduler->_signal.notify_one();
+	return true;
+}
+
+bool tonplugins::batch::scheduler::client::poll(float* output)
+{
+	if (_slot->status.load(std::memory_order_acquire) != done) {
+		return false;
+	}
+
+	memcpy(output, _slot->output.data(), _slot->output.size() * sizeof(float));
+	_slot->status.store(idle, std::memory_order_release);
+	return true;
+}
+
+bool tonplugins::batch::scheduler::client::wait(float* output, clock::time_point deadline)
+{
+	while (!poll(output)) {
+		if ((_slot->status.load(std::memory_order_relaxed) == idle) || (clock::now() >= deadline)) {
+			return false;
+		}
+		std::this_thread::yield();
+	}
+	return true;
+}
+
+bool tonplugins::batch::scheduler::client::busy() const
+{
+	uint32_t status = _slot->status.load(std::memory_order_acquire);
+	return (status == submitted) || (status == running);
+}
+
+tonplugins::batch::scheduler::scheduler(std::shared_ptr<tonplugins::batch::backend> engine, size_t max_clients) : _backend(engine), _max_clients(max_clients), _clients(0), _cost(0.), _signal(0), _running(true), _batches(0), _frames(0)
+{
+	if (!_backend || (max_clients == 0)) {
+		throw std::invalid_argument("A scheduler needs a backend and at least one client.");
+	}
+
+	// Everything is allocated up front, so neither clients nor the worker allocate while running.
+	_slots = std::make_unique<slot[]>(_max_clients);
+	for (size_t idx = 0; idx < _max_clients; idx++) {
+		_slots[idx].input.resize(_backend->input_size(), 0.f);
+		_slots[idx].output.resize(_backend->output_size(), 0.f);
+	}
+	_batch_slots.reserve(_max_clients);
+	_batch_input.resize(_backend->max_batch() * _backend->input_size(), 0.f);
+	_batch_output.resize(_backend->max_batch() * _backend->output_size(), 0.f);
+
+	_worker = std::thread([this]() { worker(); });
+}
+
+tonplugins::batch::scheduler::~scheduler()
+{
+	_running.store(false);
+	_signal.fetch_add(1);
+	_signal.notify_all();
+	_worker.join();
+}
+
+tonplugins::batch::backend& tonplugins::batch::scheduler::engine()
+{
+	return *_backend;
+}
+
+std::unique_ptr<tonplugins::batch::scheduler::client> tonplugins::batch::scheduler::connect()
+{
+	for (size_t idx = 0; idx < _max_clients; idx++) {
+		bool expected = false;
+		if (_slots[idx].in_use.compare_exchange_strong(expected, true)) {
+			_slots[idx].status.store(idle);
+			_clients.fetch_add(1);
+			return std::make_unique<client>(shared_from_this(), &_slots[idx]);
+		}
+	}
+	throw std::runtime_error("Too many clients connected to the scheduler.");
+}
+
+uint64_t tonplugins::batch::scheduler::batches() const
+{
+	return _batches.load(std::memory_order_relaxed);
+}
+
+uint64_t tonplugins::batch::scheduler::frames() const
+{
+	return _frames.load(std::memory_order_relaxed);
+}
+
+void tonplugins::batch::scheduler::worker()
+{
+	size_t const max_batch   = _backend->max_batch();
+	size_t const input_size  = _backend->input_size();
+	size_t const output_size = _backend->output_size();
+
+	auto gather = [this]() {
+		_batch_slots.clear();
+		for (size_t idx = 0; idx < _max_clients; idx++) {
+			if (_slots[idx].status.load(std::memory_order_acquire) == submitted) {
+				_batch_slots.push_back(idx);
+			}
+		}
+	};
+
+	while (_running.load()) {
+		uint32_t signal = _signal.load(std::memory_order_acquire);
+		gather();
+		if (_batch_slots.empty()) {
+			_signal.wait(signal);
+			continue;
+		}
+
+		// Give other clients a moment to submit their frames too, as long as the earliest deadline can still be met.
+		auto start = clock::now();
+		while ((_batch_slots.size() < max_batch) && (_batch_slots.size() < _clients.load(std::memory_order_relaxed))) {
+			int64_t earliest = std::numeric_limits<int64_t>::max();
+			for (size_t idx : _batch_slots) {
+				earliest = std::min(earliest, _slots[idx].deadline.load(std::memory_order_relaxed));
+			}
+
+			auto now   = clock::now();
+			auto slack = clock::time_point(clock::duration(earliest)) - now;
+			if ((slack <= std::chrono::duration<double, std::nano>(_cost * 2.)) || ((now - start) >= max_gather_time)) {
+				break;
+			}
+
+			std::this_thread::yield();
+			gather();
+		}
+
+		// Most urgent frames go first if there are more than fit into one batch.
+		std::sort(_batch_slots.begin(), _batch_slots.end(), [this](size_t a, size_t b) { return _slots[a].deadline.load(std::memory_order_relaxed) < _slots[b].deadline.load(std::memory_order_relaxed); });
+
+		size_t batch = 0;
+		for (size_t idx : _batch_slots) {
+			if (batch >= max_batch) {
+				break;
+			}
+
+			// The client may have withdrawn the frame in the meantime.
+			uint32_t expected = submitted;
+			if (!_slots[idx].status.compare_exchange_strong(expected, running, std::memory_order_acq_rel)) {
+				continue;
+			}
+			memcpy(_batch_input.data() + batch * input_size, _slots[idx].input.data(), input_size * sizeof(float));
+			_batch_slots[batch++] = idx;
+		}
+		if (batch == 0) {
+			continue;
+		}
+
+		auto before = clock::now();
+		_backend->run(_batch_input.data(), _batch_output.data(), batch);
+		double elapsed = std::chrono::duration<double, std::nano>(clock::now() - before).count();
+		_cost          = (_cost == 0.) ? elapsed : (_cost * .9 + elapsed * .1);
+
+		for (size_t frame = 0; frame < batch; frame++) {
+			slot& owner = _slots[_batch_slots[frame]];
+			memcpy(owner.output.data(), _batch_output.data() + frame * output_size, output_size * sizeof(float));
+			owner.status.store(done, std::memory_order_release);
+			owner.status.notify_all();
+		}
+
+		_batches.fetch_add(1, std::memory_order_relaxed);
+		_frames.fetch_add(batch, std::memory_order_relaxed);
+	}
+}
+
+std::shared_ptr<tonplugins::batch::scheduler> tonplugins::batch::scheduler::get(std::string_view name, std::function<std::shared_ptr<tonplugins::batch::backend>()> factory, size_t max_clients)
+{
+	std::string key = std::string("tonplugins::batch::scheduler/") + std::string(name);
+	return tonplugins::core::instance()->cached<scheduler>(key, [&factory, max_clients]() { return std::make_shared<scheduler>(factory(), max_clients); });
+}
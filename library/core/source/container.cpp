@@ -0,0 +1,181 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#include "container.hpp"
+#include "platform.hpp"
+
+#include "warning-disable.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include "warning-enable.hpp"
+
+static_assert(std::endian::native == std::endian::little, "Containers are little-endian, and are used in place.");
+
+static uint64_t align_up(uint64_t value, uint64_t alignment)
+{
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+
+tonplugins::storage::container::container(std::filesystem::path const& file)
+{
+	auto mapping = std::make_shared<tonplugins::platform::mapped_file>(file);
+	_owner       = mapping;
+	_data        = static_cast<uint8_t const*>(mapping->data());
+	_size        = mapping->size();
+	validate();
+}
+
+tonplugins::storage::container::container(void const* data, size_t size)
+{
+	_data = static_cast<uint8_t const*>(data);
+	_size = size;
+
+	// Chunks are only aligned if the container itself is.
+	if ((reinterpret_cast<uintptr_t>(data) % alignment) != 0) {
+		auto copy = std::make_shared<tonplugins::memory::aligned_vector<uint8_t>>(_data, _data + size);
+		_owner    = copy;
+		_data     = copy->data();
+	}
+
+	validate();
+}
+
+tonplugins::storage::container::~container() = default;
+
+void tonplugins::storage::container::validate()
+{
+	if (!_data || (_size < sizeof(header))) {
+		throw std::runtime_error("Container is too small.");
+	}
+
+	_header = reinterpret_cast<header const*>(_data);
+	if (_header->magic != magic) {
+		throw std::runtime_error("Not a container.");
+	}
+	if (_header->version > version) {
+		throw std::runtime_error("Container was written by a newer version.");
+	}
+	if ((_header->header_size < sizeof(header)) || (_header->size > _size)) {
+		throw std::runtime_error("Container is truncated or corrupted.");
+	}
+
+	// Everything the index points at must be inside the container, so reads can never go out of bounds.
+	// Sizes are compared against what remains, as the sum of offset and size may overflow in a hostile container.
+	if ((_header->index_offset < _header->header_size) || ((_header->index_offset % alignof(chunk)) != 0) || (_header->index_offset > _header->size) || (_header->count > ((_header->size - _header->index_offset) / sizeof(chunk)))) {
+		throw std::runtime_error("Container index is corrupted.");
+	}
+	_index = reinterpret_cast<chunk const*>(_data + _header->index_offset);
+	for (uint32_t idx = 0; idx < _header->count; idx++) {
+		chunk const& entry = _index[idx];
+		if (((entry.offset % alignment) != 0) || (entry.offset > _header->size) || (entry.size > (_header->size - entry.offset))) {
+			throw std::runtime_error("Container chunk is corrupted.");
+		}
+	}
+}
+
+uint32_t tonplugins::storage::container::type() const
+{
+	return _header->type;
+}
+
+uint32_t tonplugins::storage::container::type_version() const
+{
+	return _header->type_version;
+}
+
+std::vector<uint32_t> tonplugins::storage::container::chunks() const
+{
+	std::vector<uint32_t> result;
+	result.reserve(_header->count);
+	for (uint32_t idx = 0; idx < _header->count; idx++) {
+		result.push_back(_index[idx].id);
+	}
+	return result;
+}
+
+bool tonplugins::storage::container::contains(uint32_t id) const
+{
+	for (uint32_t idx = 0; idx < _header->count; idx++) {
+		if (_index[idx].id == id) {
+			return true;
+		}
+	}
+	return false;
+}
+
+std::span<uint8_t const> tonplugins::storage::container::get(uint32_t id) const
+{
+	// Containers hold a handful of chunks, a linear search beats anything fancier.
+	for (uint32_t idx = 0; idx < _header->count; idx++) {
+		if (_index[idx].id == id) {
+			return {_data + _index[idx].offset, static_cast<size_t>(_index[idx].size)};
+		}
+	}
+	return {};
+}
+
+tonplugins::storage::container_writer::container_writer(uint32_t type, uint32_t type_version) : _type(type), _type_version(type_version) {}
+
+tonplugins::storage::container_writer::~container_writer() = default;
+
+void tonplugins::storage::container_writer::set(uint32_t id, void const* data, size_t size)
+{
+	auto bytes = static_cast<uint8_t const*>(data);
+	auto kv    = std::find_if(_chunks.begin(), _chunks.end(), [id](entry const& v) { return v.id == id; });
+	if (kv == _chunks.end()) {
+		_chunks.push_back({id, {}});
+		kv = _chunks.end() - 1;
+	}
+	kv->data.assign(bytes, bytes + size);
+}
+
+tonplugins::memory::aligned_vector<uint8_t> tonplugins::storage::container_writer::build() const
+{
+	// Header, then every chunk on its own aligned offset, then the index.
+	uint64_t                             offset = sizeof(container::header);
+	std::vector<container::chunk> index;
+	for (auto const& entry : _chunks) {
+		offset = align_up(offset, container::alignment);
+		index.push_back({entry.id, 0, offset, entry.data.size()});
+		offset += entry.data.size();
+	}
+	uint64_t index_offset = align_up(offset, container::alignment);
+	uint64_t size         = index_offset + index.size() * sizeof(container::chunk);
+
+	tonplugins::memory::aligned_vector<uint8_t> result(static_cast<size_t>(size), 0);
+
+	container::header head = {};
+	head.magic             = container::magic;
+	head.version           = container::version;
+	head.header_size       = sizeof(container::header);
+	head.type              = _type;
+	head.type_version      = _type_version;
+	head.index_offset      = index_offset;
+	head.size              = size;
+	head.count             = static_cast<uint32_t>(index.size());
+	memcpy(result.data(), &head, sizeof(head));
+
+	for (size_t idx = 0; idx < _chunks.size(); idx++) {
+		if (!_chunks[idx].data.empty()) {
+			memcpy(result.data() + index[idx].offset, _chunks[idx].data.data(), _chunks[idx].data.size());
+		}
+	}
+	if (!index.empty()) {
+		memcpy(result.data() + index_offset, index.data(), index.size() * sizeof(container::chunk));
+	}
+
+	return result;
+}
+
+void tonplugins::storage::container_writer::save(std::filesystem::path const& file) const
+{
+	auto data = build();
+
+	if (file.has_parent_path()) {
+		std::filesystem::create_directories(file.parent_path());
+	}
+
+	tonplugins::platform::replace_file(file, data.data(), data.size());
+}
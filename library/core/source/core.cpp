@@ -9,9 +9,13 @@
 #include "warning-disable.hpp"
 #include <chrono>
 #include <cinttypes>
+#include <cstdarg>
+#include <cstdio>
+#include <future>
 #include <iostream>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 #ifdef _WIN32
 #include <Windows.h>
@@ -53,7 +57,63 @@ static std::string formatted_time(bool file_safe = false)
 	return std::string(time_buffer.data());
 };
 
-tonplugins::core::core(std::string app_name) : _app_name(app_name)
+/** Shared resources handed out by cached(), which belong to the process rather than to any one core.
+ *
+ * The lock is recursive, so that factories may retrieve other shared resources while theirs is being created.
+ */
+struct cache_registry {
+	std::recursive_mutex                                    lock;
+	std::map<std::string, std::weak_ptr<void>, std::less<>> entries;
+};
+
+static cache_registry& shared_cache()
+{
+	static cache_registry registry;
+	return registry;
+}
+
+/** Preloaded resources, which belong to the process rather than to any one core.
+ *
+ * Hosts rarely keep a core alive between creating instances, so tying preloads to one would throw them away (and wait
+ * for them) as soon as the reference that started them is released.
+ */
+struct preload_registry {
+	std::mutex                                                                    lock;
+	std::map<std::string, std::shared_future<std::shared_ptr<void>>, std::less<>> entries;
+
+	~preload_registry()
+	{
+		// Don't unload the module out from under loads that are still running.
+		std::vector<std::shared_future<std::shared_ptr<void>>> pending;
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			for (auto const& kv : entries) {
+				pending.push_back(kv.second);
+			}
+		}
+		for (auto const& future : pending) {
+			future.wait();
+		}
+	}
+};
+
+static preload_registry& preloads()
+{
+	static preload_registry registry;
+	return registry;
+}
+
+tonplugins::core::core(std::string app_name) : _app_name(app_name) {}
+
+tonplugins::core::~core()
+{
+	if (_log_stream.is_open()) {
+		_log_stream.flush();
+		_log_stream.close();
+	}
+}
+
+void tonplugins::core::initialize_paths()
 {
 	{ // Local Data Path
 		std::filesystem::path result;
@@ -169,17 +229,23 @@ tonplugins::core::core(std::string app_name) : _app_name(app_name)
 		_cache_data = result / "Xaymar" / "TonPlugIns" / _app_name;
 		std::filesystem::create_directories(_cache_data);
 	}
+}
 
-	{ // Try and open a log file
-		// Create the directory for log files if it happens to be missing.
-		std::filesystem::path log_path = std::filesystem::path(_local_data) / "logs";
-		std::filesystem::create_directories(log_path);
+void tonplugins::core::initialize_log()
+{
+	// Create the directory for log files if it happens to be missing.
+	std::filesystem::path log_path = local_data_path() / "logs";
+	std::filesystem::create_directories(log_path);
 
-		// Create the log file itself.
-		std::filesystem::path log_file = std::filesystem::path(log_path).append(formatted_time(true) + ".log");
-		_log_stream                    = std::ofstream(log_file, std::ios::trunc | std::ios::out);
+	// Create the log file itself.
+	std::filesystem::path log_file = std::filesystem::path(log_path).append(formatted_time(true) + ".log");
+	_log_stream                    = std::ofstream(log_file, std::ios::trunc | std::ios::out);
+}
 
-		// Clean up old files.
+void tonplugins::core::log_startup()
+{
+	{ // Clean up old files.
+		std::filesystem::path log_path = local_data_path() / "logs";
 		try { // Delete all log files older than 1 month.
 			for (auto& entry : std::filesystem::directory_iterator(log_path)) {
 				try {
@@ -216,31 +282,37 @@ tonplugins::core::core(std::string app_name) : _app_name(app_name)
 #endif
 }
 
-tonplugins::core::~core()
-{
-	if (_log_stream.is_open()) {
-		_log_stream.flush();
-		_log_stream.close();
-	}
-}
-
 std::filesystem::path tonplugins::core::local_data_path()
 {
+	std::call_once(_paths_once, &tonplugins::core::initialize_paths, this);
 	return std::filesystem::path(_local_data);
 }
 
 std::filesystem::path tonplugins::core::roaming_data_path()
 {
-	return std::filesystem::path(_local_data);
+	std::call_once(_paths_once, &tonplugins::core::initialize_paths, this);
+	return std::filesystem::path(_roaming_data);
 }
 
 std::filesystem::path tonplugins::core::cache_data_path()
 {
-	return std::filesystem::path(_local_data);
+	std::call_once(_paths_once, &tonplugins::core::initialize_paths, this);
+	return std::filesystem::path(_cache_data);
 }
 
 void tonplugins::core::log(std::string_view format, ...)
 {
+	// The log file is only opened by the first message. Whoever opened it also writes the introduction, which logs
+	// itself and so can't happen while the log is still being opened.
+	bool opened = false;
+	std::call_once(_log_once, [this, &opened]() {
+		initialize_log();
+		opened = true;
+	});
+	if (opened) {
+		log_startup();
+	}
+
 	// Build the string to write to the log file.
 	std::string converted;
 	{
@@ -310,6 +382,90 @@ void tonplugins::core::log(std::string_view format, ...)
 #endif
 }
 
+std::shared_ptr<void> tonplugins::core::find_cached(std::string_view key, std::function<std::shared_ptr<void>()> const& factory)
+{
+	auto&                                 registry = shared_cache();
+	std::lock_guard<std::recursive_mutex> lock(registry.lock);
+
+	if (auto kv = registry.entries.find(key); kv != registry.entries.end()) {
+		if (auto ptr = kv->second.lock(); ptr)
+			return ptr;
+		// Nobody holds it anymore, so don't let the entry linger.
+		registry.entries.erase(kv);
+	}
+
+	std::shared_ptr<void> ptr = factory();
+	registry.entries.insert_or_assign(std::string(key), ptr);
+	return ptr;
+}
+
+std::shared_future<std::shared_ptr<void>> tonplugins::core::preload(std::string_view key, std::function<std::shared_ptr<void>()> factory)
+{
+	auto&                       registry = preloads();
+	std::lock_guard<std::mutex> lock(registry.lock);
+	if (auto kv = registry.entries.find(key); kv != registry.entries.end()) {
+		return kv->second;
+	}
+
+	// The core that started the load may be long gone by the time it finishes, so log through whichever one exists then.
+	std::string name{key};
+	auto        task = [name, factory = std::move(factory)]() {
+		auto start   = std::chrono::steady_clock::now();
+		auto elapsed = [&start]() { return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(); };
+		try {
+			auto result = factory();
+			tonplugins::core::instance()->log("<tonplugins::core::preload> Loaded '%s' in %.3f ms.", name.c_str(), elapsed());
+			return result;
+		} catch (std::exception const& ex) {
+			tonplugins::core::instance()->log("<tonplugins::core::preload> Failed to load '%s' after %.3f ms: %s", name.c_str(), elapsed(), ex.what());
+			throw;
+		}
+	};
+
+	auto future = std::async(std::launch::async, std::move(task)).share();
+	registry.entries.emplace(std::move(name), future);
+	return future;
+}
+
+std::shared_future<std::shared_ptr<void>> tonplugins::core::preload_library(std::filesystem::path const& file)
+{
+	return preload("tonplugins::platform::library/" + file.string(), [file]() -> std::shared_ptr<void> { return tonplugins::platform::library::load(file); });
+}
+
+std::shared_future<std::shared_ptr<void>> tonplugins::core::preload_file(std::filesystem::path const& file)
+{
+	return preload("tonplugins::platform::mapped_file/" + file.string(), [file]() -> std::shared_ptr<void> {
+		auto mapping = std::make_shared<tonplugins::platform::mapped_file>(file);
+
+		// Touch every page, so that the first read from an instance doesn't have to wait for the disk.
+		auto    data = static_cast<uint8_t const*>(mapping->data());
+		uint8_t sum  = 0;
+		for (size_t offset = 0; offset < mapping->size(); offset += 4096) {
+			sum ^= data[offset];
+		}
+		volatile uint8_t sink = sum;
+		(void)sink;
+
+		return mapping;
+	});
+}
+
+bool tonplugins::core::is_preloaded(std::string_view key)
+{
+	auto future = find_preload(key);
+	return future.valid() && (future.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+}
+
+std::shared_future<std::shared_ptr<void>> tonplugins::core::find_preload(std::string_view key)
+{
+	auto&                       registry = preloads();
+	std::lock_guard<std::mutex> lock(registry.lock);
+	if (auto kv = registry.entries.find(key); kv != registry.entries.end()) {
+		return kv->second;
+	}
+	return {};
+}
+
 std::shared_ptr<tonplugins::core> tonplugins::core::instance(std::string app_name)
 {
 	static std::mutex                      mtx;
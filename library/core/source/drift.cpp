@@ -0,0 +1,164 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#include "drift.hpp"
+
+#include "warning-disable.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include "warning-enable.hpp"
+
+// Proportional gain, relative to the target fill level. The loop settles within a few times target / gain samples.
+constexpr double gain_proportional = 0.01;
+
+// Time constant of the fill level estimate, in multiples of the target fill level.
+constexpr double smoothing = 4.;
+
+template<typename T>
+tonplugins::memory::drift_reader<T>::drift_reader(size_t channels, size_t target, double max_deviation) : _channels(channels), _target(target), _max_deviation(max_deviation)
+{
+	if ((channels == 0) || (target == 0)) {
+		throw std::invalid_argument("Channels and target fill level must be non-zero.");
+	}
+
+	_history.resize(_channels, T(0));
+	_sources.resize(_channels, nullptr);
+
+	reset();
+}
+
+template<typename T>
+tonplugins::memory::drift_reader<T>::~drift_reader() = default;
+
+template<typename T>
+size_t tonplugins::memory::drift_reader<T>::target() const
+{
+	return _target;
+}
+
+template<typename T>
+void tonplugins::memory::drift_reader<T>::set_target(size_t target)
+{
+	if (target == 0) {
+		throw std::invalid_argument("Target fill level must be non-zero.");
+	}
+	_target = target;
+}
+
+template<typename T>
+double tonplugins::memory::drift_reader<T>::fill() const
+{
+	return _fill;
+}
+
+template<typename T>
+double tonplugins::memory::drift_reader<T>::ratio() const
+{
+	return _ratio;
+}
+
+template<typename T>
+void tonplugins::memory::drift_reader<T>::reset()
+{
+	_running  = false;
+	_fill     = 0.;
+	_integral = 0.;
+	_ratio    = 1.;
+	_fraction = 0.;
+	std::fill(_history.begin(), _history.end(), T(0));
+}
+
+template<typename T>
+size_t tonplugins::memory::drift_reader<T>::read(tonplugins::memory::ring<T>* const* rings, T* const* output, size_t samples)
+{
+	if (samples == 0) {
+		return 0;
+	}
+
+	size_t used = std::numeric_limits<size_t>::max();
+	for (size_t channel = 0; channel < _channels; channel++) {
+		used = std::min(used, rings[channel]->used());
+	}
+
+	// Wait until there is enough buffered to ride out jitter in both directions.
+	if (!_running) {
+		if (used < _target) {
+			for (size_t channel = 0; channel < _channels; channel++) {
+				memset(output[channel], 0, sizeof(T) * samples);
+			}
+			return 0;
+		}
+		_running = true;
+		_fill    = static_cast<double>(used);
+	}
+
+	// Update the fill level estimate, and steer the ratio towards holding it at the target.
+	double target = static_cast<double>(_target);
+	double alpha  = 1. - std::exp(-static_cast<double>(samples) / (smoothing * target));
+	_fill += alpha * (static_cast<double>(used) - _fill);
+
+	// Critically damped: the integral gain follows from the proportional gain and the loop time constant.
+	double error         = (_fill - target) / target;
+	double gain_integral = (gain_proportional * gain_proportional) / (4. * target);
+	_integral            = std::clamp(_integral + gain_integral * error * static_cast<double>(samples), -_max_deviation, _max_deviation);
+	_ratio               = 1. + std::clamp(gain_proportional * error + _integral, -_max_deviation, _max_deviation);
+
+	// Produce as much as the input allows, with three samples of look-ahead for the interpolation.
+	size_t count  = samples;
+	double end    = _fraction + static_cast<double>(count) * _ratio;
+	size_t needed = static_cast<size_t>(_fraction + static_cast<double>(count - 1) * _ratio) + 3;
+	if (needed > used) {
+		count = (used > 3) ? std::min(samples, static_cast<size_t>((static_cast<double>(used - 3) - _fraction) / _ratio) + 1) : 0;
+		if (count > 0) {
+			end    = _fraction + static_cast<double>(count) * _ratio;
+			needed = static_cast<size_t>(_fraction + static_cast<double>(count - 1) * _ratio) + 3;
+		}
+	}
+
+	size_t consumed = static_cast<size_t>(end);
+	if (count > 0) {
+		for (size_t channel = 0; channel < _channels; channel++) {
+			T const* data = rings[channel]->peek(needed);
+			T*       out  = output[channel];
+			T        left = _history[channel];
+
+			for (size_t idx = 0; idx < count; idx++) {
+				double position = _fraction + static_cast<double>(idx) * _ratio;
+				size_t index = static_cast<size_t>(position);
+				T      f     = static_cast<T>(position - static_cast<double>(index));
+				T      xm1   = (index > 0) ? data[index - 1] : left;
+				T      x0    = data[index];
+				T      x1    = data[index + 1];
+				T      x2    = data[index + 2];
+
+				T c1     = T(0.5) * (x1 - xm1);
+				T c2     = xm1 - T(2.5) * x0 + T(2) * x1 - T(0.5) * x2;
+				T c3     = T(0.5) * (x2 - xm1) + T(1.5) * (x0 - x1);
+				out[idx] = ((c3 * f + c2) * f + c1) * f + x0;
+			}
+
+			if (consumed > 0) {
+				_history[channel] = data[consumed - 1];
+			}
+			rings[channel]->read(consumed, nullptr);
+		}
+		_fraction = end - static_cast<double>(consumed);
+	}
+
+	// Ran dry, so output silence for the rest and start over once the target is reached again.
+	if (count < samples) {
+		for (size_t channel = 0; channel < _channels; channel++) {
+			memset(output[channel] + count, 0, sizeof(T) * (samples - count));
+		}
+		reset();
+	}
+
+	return count;
+}
+
+template class tonplugins::memory::drift_reader<float>;
+template class tonplugins::memory::drift_reader<double>;
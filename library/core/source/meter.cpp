@@ -0,0 +1,204 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#include "meter.hpp"
+#include "simd.hpp"
+
+#include "warning-disable.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numbers>
+#include <stdexcept>
+#include "warning-enable.hpp"
+
+// True-peak estimation through 4x polyphase interpolation, similar to ITU-R BS.1770-4 Annex 2.
+constexpr size_t true_peak_phases = 4;
+constexpr size_t true_peak_taps   = 12;
+// Samples are processed through the interpolator in chunks of this size, so the history buffer stays tiny.
+constexpr size_t true_peak_chunk = 64;
+
+static double bessel_i0(double x)
+{
+	double sum  = 1.;
+	double term = 1.;
+	for (size_t k = 1; k < 32; k++) {
+		term *= (x / (2. * static_cast<double>(k))) * (x / (2. * static_cast<double>(k)));
+		sum += term;
+	}
+	return sum;
+}
+
+tonplugins::meter::meter(size_t channels, double sample_rate, double refresh_rate, double rms_window) : _channels(channels), _position(0), _sequence(0), _state(), _true_peak_coefficients(true_peak_taps * true_peak_phases), _active(false), _snapshots()
+{
+	if ((channels == 0) || (channels > max_channels)) {
+		throw std::invalid_argument("Unsupported number of channels.");
+	}
+	if ((sample_rate <= 0.) || (refresh_rate <= 0.) || (rms_window <= 0.)) {
+		throw std::invalid_argument("Sample rate, refresh rate and RMS window must be positive.");
+	}
+
+	_period          = std::max<size_t>(1, static_cast<size_t>(std::round(sample_rate / refresh_rate)));
+	_rms_coefficient = static_cast<float>(1. - std::exp(-(static_cast<double>(_period) / sample_rate) / rms_window));
+
+	_state.resize(_channels);
+	for (auto& state : _state) {
+		state.history.resize(true_peak_taps - 1 + true_peak_chunk, 0.f);
+	}
+
+	{ // Kaiser windowed sinc interpolator, stored tap-major so all phases are computed in one vector.
+		constexpr double beta   = 8.;
+		constexpr double center = static_cast<double>(true_peak_taps / 2) - 1.;
+		constexpr double span   = static_cast<double>(true_peak_taps / 2);
+		for (size_t phase = 0; phase < true_peak_phases; phase++) {
+			double fraction = static_cast<double>(phase) / static_cast<double>(true_peak_phases);
+			double sum      = 0.;
+			for (size_t tap = 0; tap < true_peak_taps; tap++) {
+				double x      = (center + fraction) - static_cast<double>(tap);
+				double sinc   = (std::abs(x) < 1e-9) ? 1. : std::sin(std::numbers::pi * x) / (std::numbers::pi * x);
+				double window = bessel_i0(beta * std::sqrt(std::max(0., 1. - (x / span) * (x / span)))) / bessel_i0(beta);
+				double value  = sinc * window;
+				_true_peak_coefficients[tap * true_peak_phases + phase] = static_cast<float>(value);
+				sum += value;
+			}
+			for (size_t tap = 0; tap < true_peak_taps; tap++) {
+				_true_peak_coefficients[tap * true_peak_phases + phase] /= static_cast<float>(sum);
+			}
+		}
+	}
+
+	reset();
+}
+
+tonplugins::meter::~meter() = default;
+
+void tonplugins::meter::process(float const* const* data, size_t samples)
+{
+	if (!_active.load(std::memory_order_relaxed)) {
+		return;
+	}
+
+	size_t offset = 0;
+	while (samples > 0) {
+		size_t length = std::min(samples, _period - _position);
+		for (size_t idx = 0; idx < _channels; idx++) {
+			measure(_state[idx], data[idx] + offset, length);
+		}
+
+		_position += length;
+		offset += length;
+		samples -= length;
+
+		if (_position == _period) {
+			flush();
+		}
+	}
+}
+
+void tonplugins::meter::reset()
+{
+	for (auto& state : _state) {
+		state.peak      = 0.f;
+		state.sum_sq    = 0.f;
+		state.mean_sq   = 0.f;
+		state.true_peak = 0.f;
+		std::fill(state.history.begin(), state.history.end(), 0.f);
+	}
+	_position = 0;
+}
+
+void tonplugins::meter::set_active(bool active)
+{
+	_active.store(active, std::memory_order_relaxed);
+}
+
+bool tonplugins::meter::is_active() const
+{
+	return _active.load(std::memory_order_relaxed);
+}
+
+bool tonplugins::meter::poll(snapshot& out)
+{
+	if (!_snapshots.poll()) {
+		return false;
+	}
+	out = _snapshots.front();
+	return true;
+}
+
+void tonplugins::meter::measure(channel& state, float const* data, size_t samples)
+{
+	using tonplugins::simd::f32x4;
+
+	{ // Peak and sum of squares.
+		f32x4  peak   = f32x4::zero();
+		f32x4  sum_sq = f32x4::zero();
+		size_t idx    = 0;
+		for (; (idx + f32x4::width) <= samples; idx += f32x4::width) {
+			f32x4 v = f32x4::load(data + idx);
+			peak    = tonplugins::simd::max(peak, tonplugins::simd::abs(v));
+			sum_sq  = tonplugins::simd::madd(v, v, sum_sq);
+		}
+		float peak_s   = tonplugins::simd::hmax(peak);
+		float sum_sq_s = tonplugins::simd::hsum(sum_sq);
+		for (; idx < samples; idx++) {
+			peak_s = std::max(peak_s, std::fabs(data[idx]));
+			sum_sq_s += data[idx] * data[idx];
+		}
+		state.peak = std::max(state.peak, peak_s);
+		state.sum_sq += sum_sq_s;
+	}
+
+	{ // True-peak, all four phases of the interpolator are evaluated at once.
+		f32x4 coefficients[true_peak_taps];
+		for (size_t tap = 0; tap < true_peak_taps; tap++) {
+			coefficients[tap] = f32x4::load(_true_peak_coefficients.data() + tap * true_peak_phases);
+		}
+
+		f32x4  true_peak = f32x4::zero();
+		float* history   = state.history.data();
+		while (samples > 0) {
+			size_t length = std::min(samples, true_peak_chunk);
+			memcpy(history + (true_peak_taps - 1), data, length * sizeof(float));
+
+			for (size_t idx = 0; idx < length; idx++) {
+				f32x4 acc = f32x4::zero();
+				for (size_t tap = 0; tap < true_peak_taps; tap++) {
+					acc = tonplugins::simd::madd(f32x4::broadcast(history[idx + tap]), coefficients[tap], acc);
+				}
+				true_peak = tonplugins::simd::max(true_peak, tonplugins::simd::abs(acc));
+			}
+
+			// Keep the tail around for the next chunk.
+			memmove(history, history + length, (true_peak_taps - 1) * sizeof(float));
+
+			data += length;
+			samples -= length;
+		}
+		state.true_peak = std::max(state.true_peak, tonplugins::simd::hmax(true_peak));
+	}
+}
+
+void tonplugins::meter::flush()
+{
+	snapshot& out = _snapshots.back();
+	out.sequence  = ++_sequence;
+	out.channels  = _channels;
+
+	for (size_t idx = 0; idx < _channels; idx++) {
+		channel& state = _state[idx];
+		state.mean_sq += _rms_coefficient * ((state.sum_sq / static_cast<float>(_period)) - state.mean_sq);
+
+		out.peak[idx]      = state.peak;
+		out.rms[idx]       = std::sqrt(state.mean_sq);
+		out.true_peak[idx] = std::max(state.true_peak, state.peak);
+
+		state.peak      = 0.f;
+		state.sum_sq    = 0.f;
+		state.true_peak = 0.f;
+	}
+
+	_snapshots.publish();
+	_position = 0;
+}
@@ -3,8 +3,13 @@
 #include "platform.hpp"
 
 #include "warning-disable.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cinttypes>
 #include <filesystem>
 #include <memory>
+#include <mutex>
+#include <stdexcept>
 #include <string>
 #include <unordered_map>
 
@@ -18,6 +23,10 @@
 #include <Windows.h>
 #elif defined(ST_UNIX)
 #include <dlfcn.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #endif
 #include "warning-enable.hpp"
 
@@ -102,19 +111,35 @@ void* tonplugins::platform::library::load_symbol(std::string_view name)
 	return reinterpret_cast<void*>(dlsym(_library, name.data()));
 #endif
 }
+
+void* tonplugins::platform::library::native_handle()
+{
+	return _library;
+}
+
 std::shared_ptr<::tonplugins::platform::library> tonplugins::platform::library::load(std::filesystem::path file)
 {
+	static std::mutex                                                                      lock;
 	static std::unordered_map<std::string, std::weak_ptr<::tonplugins::platform::library>> libraries;
 
-	auto kv = libraries.find(file.string());
-	if (kv != libraries.end()) {
-		if (auto ptr = kv->second.lock(); ptr)
-			return ptr;
-		libraries.erase(kv);
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		if (auto kv = libraries.find(file.string()); kv != libraries.end()) {
+			if (auto ptr = kv->second.lock(); ptr)
+				return ptr;
+		}
 	}
 
+	// Loading can take a long time, so don't hold up other threads meanwhile.
 	auto ptr = std::make_shared<::tonplugins::platform::library>(file);
-	libraries.emplace(file.string(), ptr);
+
+	// Someone else may have loaded it in the meantime, in which case theirs is kept and ours is just a reference.
+	std::lock_guard<std::mutex> guard(lock);
+	if (auto kv = libraries.find(file.string()); kv != libraries.end()) {
+		if (auto other = kv->second.lock(); other)
+			return other;
+	}
+	libraries.insert_or_assign(file.string(), ptr);
 
 	return ptr;
 }
@@ -123,3 +148,186 @@ std::shared_ptr<::tonplugins::platform::library> tonplugins::platform::library::
 {
 	return load(std::filesystem::path(name));
 }
+
+tonplugins::platform::mapped_file::mapped_file(std::filesystem::path const& file) : _data(nullptr), _size(0)
+{
+#if defined(ST_WINDOWS)
+	_mapping = nullptr;
+
+	HANDLE handle = CreateFileW(file.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (handle == INVALID_HANDLE_VALUE) {
+		throw std::runtime_error("Failed to open '" + file.string() + "'.");
+	}
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(handle, &size)) {
+		CloseHandle(handle);
+		throw std::runtime_error("Failed to query the size of '" + file.string() + "'.");
+	}
+	_size = static_cast<size_t>(size.QuadPart);
+
+	// Empty files can't be mapped, but they're still valid files.
+	if (_size > 0) {
+		_mapping = CreateFileMappingW(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (_mapping) {
+			_data = MapViewOfFile(reinterpret_cast<HANDLE>(_mapping), FILE_MAP_READ, 0, 0, 0);
+		}
+		if (!_data) {
+			if (_mapping) {
+				CloseHandle(reinterpret_cast<HANDLE>(_mapping));
+			}
+			CloseHandle(handle);
+			throw std::runtime_error("Failed to map '" + file.string() + "'.");
+		}
+	}
+
+	// The mapping keeps its own reference to the file.
+	CloseHandle(handle);
+#elif defined(ST_UNIX)
+	int fd = open(file.string().c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0) {
+		throw std::runtime_error("Failed to open '" + file.string() + "'.");
+	}
+
+	struct stat info;
+	if (fstat(fd, &info) != 0) {
+		close(fd);
+		throw std::runtime_error("Failed to query the size of '" + file.string() + "'.");
+	}
+	_size = static_cast<size_t>(info.st_size);
+
+	// Empty files can't be mapped, but they're still valid files.
+	if (_size > 0) {
+		void* area = mmap(nullptr, _size, PROT_READ, MAP_SHARED, fd, 0);
+		if (area == MAP_FAILED) {
+			close(fd);
+			throw std::runtime_error("Failed to map '" + file.string() + "'.");
+		}
+		_data = area;
+	}
+
+	// The mapping keeps its own reference to the file.
+	close(fd);
+#endif
+}
+
+tonplugins::platform::mapped_file::~mapped_file()
+{
+#if defined(ST_WINDOWS)
+	if (_data) {
+		UnmapViewOfFile(_data);
+	}
+	if (_mapping) {
+		CloseHandle(reinterpret_cast<HANDLE>(_mapping));
+	}
+#elif defined(ST_UNIX)
+	if (_data) {
+		munmap(_data, _size);
+	}
+#endif
+}
+
+void const* tonplugins::platform::mapped_file::data() const
+{
+	return _data;
+}
+
+size_t tonplugins::platform::mapped_file::size() const
+{
+	return _size;
+}
+
+void tonplugins::platform::mapped_file::release(size_t offset, size_t length) const
+{
+	if (!_data || (offset >= _size)) {
+		return;
+	}
+	length = std::min(length, _size - offset);
+
+#if defined(ST_WINDOWS)
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	size_t page = info.dwPageSize;
+#elif defined(ST_UNIX)
+	size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+
+	size_t first = (offset + page - 1) / page * page;
+	size_t last  = (offset + length) / page * page;
+	if (last <= first) {
+		return;
+	}
+
+#if defined(ST_WINDOWS)
+	// Unlocking pages that were never locked removes them from the working set, which is exactly what is wanted here.
+	VirtualUnlock(static_cast<uint8_t*>(_data) + first, last - first);
+#elif defined(ST_UNIX)
+	madvise(static_cast<uint8_t*>(_data) + first, last - first, MADV_DONTNEED);
+#endif
+}
+
+void tonplugins::platform::replace_file(std::filesystem::path const& file, void const* data, size_t size)
+{
+	std::filesystem::path temporary = file;
+	temporary += ".tmp";
+
+	auto bytes = static_cast<uint8_t const*>(data);
+#if defined(ST_WINDOWS)
+	HANDLE handle = CreateFileW(temporary.wstring().c_str(), GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (handle == INVALID_HANDLE_VALUE) {
+		throw std::runtime_error("Failed to create '" + temporary.string() + "'.");
+	}
+	bool written = true;
+	for (size_t offset = 0; written && (offset < size);) {
+		DWORD chunk = static_cast<DWORD>(std::min<size_t>(size - offset, 0x40000000));
+		DWORD done  = 0;
+		written     = WriteFile(handle, bytes + offset, chunk, &done, NULL) && (done > 0);
+		offset += done;
+	}
+	written = written && FlushFileBuffers(handle);
+	CloseHandle(handle);
+	if (!written) {
+		DeleteFileW(temporary.wstring().c_str());
+		throw std::runtime_error("Failed to write '" + temporary.string() + "'.");
+	}
+
+	if (!MoveFileExW(temporary.wstring().c_str(), file.wstring().c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+		DeleteFileW(temporary.wstring().c_str());
+		throw std::runtime_error("Failed to replace '" + file.string() + "'.");
+	}
+#elif defined(ST_UNIX)
+	int fd = open(temporary.string().c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if (fd < 0) {
+		throw std::runtime_error("Failed to create '" + temporary.string() + "'.");
+	}
+	bool written = true;
+	for (size_t offset = 0; written && (offset < size);) {
+		ssize_t done = write(fd, bytes + offset, size - offset);
+		if (done > 0) {
+			offset += static_cast<size_t>(done);
+		} else if ((done < 0) && (errno == EINTR)) {
+			continue;
+		} else {
+			written = false;
+		}
+	}
+	written = (fsync(fd) == 0) && written;
+	written = (close(fd) == 0) && written;
+	if (!written) {
+		unlink(temporary.string().c_str());
+		throw std::runtime_error("Failed to write '" + temporary.string() + "'.");
+	}
+
+	if (rename(temporary.string().c_str(), file.string().c_str()) != 0) {
+		unlink(temporary.string().c_str());
+		throw std::runtime_error("Failed to replace '" + file.string() + "'.");
+	}
+
+	// The rename itself only survives a power loss once the directory has been flushed as well.
+	std::filesystem::path directory = file.has_parent_path() ? file.parent_path() : std::filesystem::path(".");
+	if (int dir = open(directory.string().c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC); dir >= 0) {
+		fsync(dir);
+		close(dir);
+	}
+#endif
+}
@@ -0,0 +1,317 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#include "presets.hpp"
+#include "core.hpp"
+
+#include "warning-disable.hpp"
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include <system_error>
+#include <tuple>
+#include "warning-enable.hpp"
+
+struct tonplugins::storage::preset_library::record {
+	int64_t  modified;
+	uint64_t size;
+	// Offset and length of each string in the "STRS" chunk.
+	uint32_t file[2];
+	uint32_t name[2];
+	uint32_t author[2];
+	uint32_t category[2];
+	uint32_t tags[2];
+	uint32_t search[2]; // Everything above except the file, in lower case.
+};
+
+constexpr uint32_t chunk_meta    = tonplugins::storage::fourcc("META");
+constexpr uint32_t chunk_records = tonplugins::storage::fourcc("ENTR");
+constexpr uint32_t chunk_strings = tonplugins::storage::fourcc("STRS");
+constexpr uint32_t chunk_failed  = tonplugins::storage::fourcc("FAIL"); // Presets that couldn't be read, only file is set.
+
+static std::string lower(std::string_view text)
+{
+	std::string result(text);
+	for (char& chr : result) {
+		if ((chr >= 'A') && (chr <= 'Z')) {
+			chr = static_cast<char>(chr - 'A' + 'a');
+		}
+	}
+	return result;
+}
+
+static std::string utf8(std::filesystem::path const& path)
+{
+	auto text = path.generic_u8string();
+	return std::string(text.begin(), text.end());
+}
+
+void tonplugins::storage::write_preset_info(container_writer& writer, preset_info const& info)
+{
+	// Each string is stored as its length followed by its bytes.
+	std::vector<uint8_t> data;
+	for (std::string const* text : {&info.name, &info.author, &info.category, &info.tags}) {
+		uint32_t length = static_cast<uint32_t>(text->size());
+		size_t   offset = data.size();
+		data.resize(offset + sizeof(length) + length);
+		memcpy(data.data() + offset, &length, sizeof(length));
+		memcpy(data.data() + offset + sizeof(length), text->data(), length);
+	}
+	writer.set(chunk_meta, data.data(), data.size());
+}
+
+tonplugins::storage::preset_info tonplugins::storage::read_preset_info(container const& preset)
+{
+	if (preset.type() != preset_type) {
+		throw std::runtime_error("Container is not a preset.");
+	}
+
+	auto        data   = preset.get(chunk_meta);
+	size_t      offset = 0;
+	preset_info info;
+	for (std::string* text : {&info.name, &info.author, &info.category, &info.tags}) {
+		uint32_t length = 0;
+		if ((data.size() - offset) < sizeof(length)) {
+			throw std::runtime_error("Preset information is corrupted.");
+		}
+		memcpy(&length, data.data() + offset, sizeof(length));
+		offset += sizeof(length);
+		if ((data.size() - offset) < length) {
+			throw std::runtime_error("Preset information is corrupted.");
+		}
+		text->assign(reinterpret_cast<char const*>(data.data() + offset), length);
+		offset += length;
+	}
+	return info;
+}
+
+tonplugins::storage::preset_library::preset_library() : preset_library(tonplugins::core::instance()->roaming_data_path() / "Presets", tonplugins::core::instance()->cache_data_path() / "presets.index") {}
+
+tonplugins::storage::preset_library::preset_library(std::filesystem::path directory, std::filesystem::path index_file) : _directory(std::move(directory)), _index_file(std::move(index_file))
+{
+	// An index from an older version, or a damaged one, is simply rebuilt.
+	try {
+		_index = std::make_unique<container>(_index_file);
+		if ((_index->type() != index_type) || (_index->type_version() != index_version)) {
+			_index.reset();
+		} else {
+			// Check the layout once, so at() and search() don't have to.
+			auto   strings = _index->get(chunk_strings);
+			size_t pool    = strings.size();
+			auto   entries = records();
+			auto   failed  = failures();
+			for (auto const* list : {&entries, &failed}) {
+				for (auto const& entry : *list) {
+					for (uint32_t const* str : {entry.file, entry.name, entry.author, entry.category, entry.tags, entry.search}) {
+						if ((str[0] > pool) || (str[1] > (pool - str[0]))) {
+							throw std::runtime_error("Preset index is corrupted.");
+						}
+					}
+				}
+			}
+		}
+	} catch (std::exception const&) {
+		_index.reset();
+	}
+
+	if (!_index) {
+		refresh();
+	}
+}
+
+tonplugins::storage::preset_library::~preset_library() = default;
+
+std::filesystem::path const& tonplugins::storage::preset_library::directory() const
+{
+	return _directory;
+}
+
+size_t tonplugins::storage::preset_library::size() const
+{
+	return records().size();
+}
+
+tonplugins::storage::preset_library::preset tonplugins::storage::preset_library::at(size_t index) const
+{
+	auto entries = records();
+	if (index >= entries.size()) {
+		throw std::out_of_range("Preset index out of range.");
+	}
+
+	record const& entry = entries[index];
+	return {
+		string(entry.file[0], entry.file[1]),
+		string(entry.name[0], entry.name[1]),
+		string(entry.author[0], entry.author[1]),
+		string(entry.category[0], entry.category[1]),
+		string(entry.tags[0], entry.tags[1]),
+	};
+}
+
+std::vector<size_t> tonplugins::storage::preset_library::search(std::string_view query) const
+{
+	std::vector<std::string> terms;
+	for (size_t pos = 0; pos < query.size();) {
+		size_t end = std::min(query.find(' ', pos), query.size());
+		if (end > pos) {
+			terms.push_back(lower(query.substr(pos, end - pos)));
+		}
+		pos = end + 1;
+	}
+
+	std::vector<size_t> result;
+	auto                entries = records();
+	for (size_t idx = 0; idx < entries.size(); idx++) {
+		std::string_view haystack = string(entries[idx].search[0], entries[idx].search[1]);
+		if (std::all_of(terms.begin(), terms.end(), [haystack](std::string const& term) { return haystack.find(term) != std::string_view::npos; })) {
+			result.push_back(idx);
+		}
+	}
+	return result;
+}
+
+size_t tonplugins::storage::preset_library::refresh()
+{
+	struct found {
+		std::string file;
+		int64_t     modified;
+		uint64_t    size;
+		preset_info info;
+	};
+
+	// Presets that didn't change since the last refresh are taken from the index, including those that failed to read.
+	std::map<std::string_view, record const*> known;
+	std::map<std::string_view, record const*> known_failed;
+	for (auto const& entry : records()) {
+		known.emplace(string(entry.file[0], entry.file[1]), &entry);
+	}
+	for (auto const& entry : failures()) {
+		known_failed.emplace(string(entry.file[0], entry.file[1]), &entry);
+	}
+
+	std::vector<found> presets;
+	std::vector<found> failed;
+	size_t             parsed = 0;
+	std::error_code    ec;
+	if (std::filesystem::is_directory(_directory, ec)) {
+		for (auto it = std::filesystem::recursive_directory_iterator(_directory, std::filesystem::directory_options::skip_permission_denied, ec); !ec && (it != std::filesystem::recursive_directory_iterator()); it.increment(ec)) {
+			// Errors about single entries must not end the iteration.
+			std::error_code entry_ec;
+			if (!it->is_regular_file(entry_ec) || (it->path().extension() != extension)) {
+				continue;
+			}
+
+			found entry;
+			entry.file     = utf8(it->path().lexically_relative(_directory));
+			entry.size     = static_cast<uint64_t>(it->file_size(entry_ec));
+			entry.modified = static_cast<int64_t>(it->last_write_time(entry_ec).time_since_epoch().count());
+			if (entry_ec) {
+				continue;
+			}
+
+			if (auto kv = known.find(entry.file); (kv != known.end()) && (kv->second->size == entry.size) && (kv->second->modified == entry.modified)) {
+				record const& old = *kv->second;
+				entry.info.name     = string(old.name[0], old.name[1]);
+				entry.info.author   = string(old.author[0], old.author[1]);
+				entry.info.category = string(old.category[0], old.category[1]);
+				entry.info.tags     = string(old.tags[0], old.tags[1]);
+			} else if (auto kv = known_failed.find(entry.file); (kv != known_failed.end()) && (kv->second->size == entry.size) && (kv->second->modified == entry.modified)) {
+				failed.push_back(std::move(entry));
+				continue;
+			} else {
+				try {
+					entry.info = read_preset_info(container(it->path()));
+					parsed++;
+				} catch (std::exception const& ex) {
+					CLOG("Skipping preset '%s': %s", it->path().string().c_str(), ex.what());
+					failed.push_back(std::move(entry));
+					continue;
+				}
+			}
+
+			presets.push_back(std::move(entry));
+		}
+	}
+
+	// Browse order.
+	std::sort(presets.begin(), presets.end(), [](found const& a, found const& b) {
+		auto key_a = std::make_tuple(lower(a.info.category), lower(a.info.name), a.file);
+		auto key_b = std::make_tuple(lower(b.info.category), lower(b.info.name), b.file);
+		return key_a < key_b;
+	});
+
+	// Lay out the new index.
+	std::vector<record> entries(presets.size());
+	std::string         pool;
+	auto                intern = [&pool](uint32_t(&str)[2], std::string_view text) {
+        str[0] = static_cast<uint32_t>(pool.size());
+        str[1] = static_cast<uint32_t>(text.size());
+        pool.append(text);
+	};
+	for (size_t idx = 0; idx < presets.size(); idx++) {
+		auto const& src = presets[idx];
+		record&     dst = entries[idx];
+		dst             = {};
+		dst.modified    = src.modified;
+		dst.size        = src.size;
+		intern(dst.file, src.file);
+		intern(dst.name, src.info.name);
+		intern(dst.author, src.info.author);
+		intern(dst.category, src.info.category);
+		intern(dst.tags, src.info.tags);
+		intern(dst.search, lower(src.info.name + "\n" + src.info.author + "\n" + src.info.category + "\n" + src.info.tags));
+	}
+	std::vector<record> rejected(failed.size());
+	for (size_t idx = 0; idx < failed.size(); idx++) {
+		record& dst  = rejected[idx];
+		dst          = {};
+		dst.modified = failed[idx].modified;
+		dst.size     = failed[idx].size;
+		intern(dst.file, failed[idx].file);
+	}
+
+	container_writer writer(index_type, index_version);
+	writer.set(chunk_records, entries.data(), entries.size() * sizeof(record));
+	writer.set(chunk_strings, pool.data(), pool.size());
+	writer.set(chunk_failed, rejected.data(), rejected.size() * sizeof(record));
+
+	// Let go of the old index first, as Windows refuses to replace files that are still mapped.
+	known.clear();
+	known_failed.clear();
+	_index.reset();
+	_memory.clear();
+	try {
+		writer.save(_index_file);
+		_index = std::make_unique<container>(_index_file);
+	} catch (std::exception const& ex) {
+		CLOG("Failed to write preset index '%s', keeping it in memory: %s", _index_file.string().c_str(), ex.what());
+		_memory = writer.build();
+		_index  = std::make_unique<container>(_memory.data(), _memory.size());
+	}
+
+	return parsed;
+}
+
+std::span<tonplugins::storage::preset_library::record const> tonplugins::storage::preset_library::records() const
+{
+	if (!_index) {
+		return {};
+	}
+	return _index->get_as<record>(chunk_records);
+}
+
+std::span<tonplugins::storage::preset_library::record const> tonplugins::storage::preset_library::failures() const
+{
+	if (!_index) {
+		return {};
+	}
+	return _index->get_as<record>(chunk_failed);
+}
+
+std::string_view tonplugins::storage::preset_library::string(uint32_t offset, uint32_t length) const
+{
+	auto strings = _index->get(chunk_strings);
+	return {reinterpret_cast<char const*>(strings.data()) + offset, length};
+}
@@ -0,0 +1,63 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#include "reframer.hpp"
+
+#include "warning-disable.hpp"
+#include <cstring>
+#include <stdexcept>
+#include "warning-enable.hpp"
+
+template<typename T>
+tonplugins::memory::reframer<T>::reframer(size_t channels, size_t frame, size_t max_block, size_t engine_latency) : _channels(channels), _frame(frame), _max_block(max_block), _engine_latency(engine_latency)
+{
+	if ((channels == 0) || (frame == 0) || (max_block == 0)) {
+		throw std::invalid_argument("Channels, frame size and block size must be non-zero.");
+	}
+
+	// Neither ring may ever fill up completely, as a full ring is indistinguishable from an empty one.
+	size_t capacity = (_frame * 2) + _max_block;
+	for (size_t idx = 0; idx < _channels; idx++) {
+		_input.emplace_back(std::make_unique<tonplugins::memory::ring<T>>(capacity));
+		_output.emplace_back(std::make_unique<tonplugins::memory::ring<T>>(capacity));
+	}
+	_sources.resize(_channels, nullptr);
+	_targets.resize(_channels, nullptr);
+
+	reset();
+}
+
+template<typename T>
+tonplugins::memory::reframer<T>::~reframer() = default;
+
+template<typename T>
+size_t tonplugins::memory::reframer<T>::frame() const
+{
+	return _frame;
+}
+
+template<typename T>
+size_t tonplugins::memory::reframer<T>::latency() const
+{
+	return (_frame - 1) + _engine_latency;
+}
+
+template<typename T>
+void tonplugins::memory::reframer<T>::reset()
+{
+	for (size_t idx = 0; idx < _channels; idx++) {
+		_input[idx]->read(_input[idx]->used(), nullptr);
+		_output[idx]->read(_output[idx]->used(), nullptr);
+
+		// Prime the output, so that a complete block can be returned before the first frame has been processed.
+		if (_frame > 1) {
+			T* ptr = _output[idx]->poke(_frame - 1);
+			memset(ptr, 0, sizeof(T) * (_frame - 1));
+			_output[idx]->write(_frame - 1, nullptr);
+		}
+	}
+}
+
+template class tonplugins::memory::reframer<float>;
+template class tonplugins::memory::reframer<double>;
@@ -8,6 +8,9 @@
 
 #include "warning-disable.hpp"
 #include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
 #include <stdexcept>
 
 #ifdef _WIN32
@@ -17,6 +20,8 @@
 // Fix missing VirtualAlloc2
 #pragma comment(lib, "mincore")
 #else
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <unistd.h>
 #endif
 
@@ -39,6 +44,7 @@ struct internal_data {
 	std::shared_ptr<void> left  = nullptr;
 	std::shared_ptr<void> right = nullptr;
 #else
+	std::shared_ptr<void> area = nullptr;
 #endif
 };
 
@@ -186,8 +192,47 @@ tonplugins::memory::ring<T>::ring(size_t size) : _write_pos(0), _read_pos(0), _n
 		throw std::runtime_error("Windows versions below Windows XP are just not supported.");
 	}
 #else
-	throw std::runtime_error("Not yet implemented.");
-#pragma error("Not yet implemented.");
+	// Create an anonymous shared memory object to map twice.
+	int fd = -1;
+#if defined(__linux__)
+	fd = memfd_create("tonplugins-ring", MFD_CLOEXEC);
+#endif
+	if (fd == -1) {
+		// Fall back to POSIX shared memory, which must be unlinked immediately to remain anonymous.
+		char name[64];
+		snprintf(name, sizeof(name), "/tonplugins-ring-%ld-%zx", static_cast<long>(getpid()), reinterpret_cast<size_t>(this));
+		fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+		if (fd == -1) {
+			CLOG_THIS("shm_open failed with error code %d.", errno);
+			throw std::runtime_error("Failed to allocate ring buffer memory.");
+		}
+		shm_unlink(name);
+	}
+	std::shared_ptr<void> file{reinterpret_cast<void*>(static_cast<intptr_t>(fd)), [](void* ptr) { close(static_cast<int>(reinterpret_cast<intptr_t>(ptr))); }};
+
+	if (ftruncate(fd, static_cast<off_t>(real_size)) != 0) {
+		CLOG_THIS("ftruncate failed with error code %d.", errno);
+		throw std::runtime_error("Failed to allocate ring buffer memory.");
+	}
+
+	// Reserve the continuous memory region.
+	void* area = mmap(nullptr, wide_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (area == MAP_FAILED) {
+		CLOG_THIS("mmap failed to reserve memory with error code %d.", errno);
+		throw std::runtime_error("Failed to allocate ring buffer memory.");
+	}
+	id->area = std::shared_ptr<void>{area, [wide_size](void* ptr) { munmap(ptr, wide_size); }};
+
+	// Map both halves on top of the reservation.
+	for (size_t half = 0; half < 2; half++) {
+		void* view = mmap(reinterpret_cast<uint8_t*>(area) + (real_size * half), real_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+		if (view == MAP_FAILED) {
+			CLOG_THIS("mmap failed to map %s half with error code %d.", half ? "right" : "left", errno);
+			throw std::runtime_error("Failed to allocate ring buffer memory.");
+		}
+	}
+
+	_buffer = reinterpret_cast<T*>(area);
 #endif
 }
 
@@ -212,13 +257,17 @@ size_t tonplugins::memory::ring<T>::write(size_t size, T const* buffer)
 		memcpy(_buffer + static_cast<int64_t>(_write_pos), buffer, sizeof(T) * elements);
 	}
 
+	// The reader may move the read position concurrently, so look at it only once, and before the new data is visible.
+	// Otherwise a reader that already consumed this very write would look like it was overwritten.
+	size_t read_pos = _read_pos;
+
 	// Advance the write position by the number of elements, wrapped into the actual buffer size.
 	size_t write_old = _write_pos;
 	size_t write_new = write_old + elements;
 	_write_pos       = write_new % _size;
 
 	// Advance the read position if we just overwrite part of it.
-	if ((write_old < _read_pos) && (write_new >= _read_pos)) {
+	if ((write_old < read_pos) && (write_new >= read_pos)) {
 		// (w0 < r) && (w1 >= r), c=10
 		//Read caught up to write:
 		// s=5, r=0, w=0: (0 < 0) && (5 >= 0) = false (should be false)
@@ -291,13 +340,17 @@ size_t tonplugins::memory::ring<T>::read(size_t size, T* buffer)
 template<typename T>
 size_t tonplugins::memory::ring<T>::used()
 {
+	// Load each position only once, as the other side may move it at any time.
+	size_t write_pos = _write_pos;
+	size_t read_pos  = _read_pos;
+
 	// Is the write pointer in front or on the read pointer?
-	if (_write_pos >= _read_pos) {
+	if (write_pos >= read_pos) {
 		// If yes, just subtract the read position from the write position.
-		return _write_pos - _read_pos;
+		return write_pos - read_pos;
 	} else {
 		// Otherwise, treat the write position as a number of elements, and the read position needs to be subtracted from the size.
-		return _write_pos + (_size - _read_pos);
+		return write_pos + (_size - read_pos);
 	}
 }
 
@@ -0,0 +1,359 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#include "shared_ring.hpp"
+#include "core.hpp"
+
+#include "warning-disable.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+#ifdef _WIN32
+#include <Windows.h>
+#include "platform.hpp"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+#endif
+
+#include "warning-enable.hpp"
+
+// Both processes must agree on the layout, which is only possible with lock-free atomics.
+static_assert(std::atomic<uint64_t>::is_always_lock_free);
+static_assert(std::atomic<uint32_t>::is_always_lock_free);
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t));
+
+// Keep the data page-aligned behind the header.
+constexpr size_t header_size = 4096;
+
+template<typename T>
+struct tonplugins::memory::shared_ring<T>::header {
+	std::atomic<uint32_t> magic;
+	uint32_t              version;
+	uint32_t              element_size;
+	uint32_t              reserved;
+	uint64_t              capacity;
+
+	// Only written by the writer.
+	alignas(64) std::atomic<uint64_t> write_pos;
+	std::atomic<uint32_t> data_signal;
+	std::atomic<uint32_t> data_waiters;
+
+	// Only written by the reader.
+	alignas(64) std::atomic<uint64_t> read_pos;
+	std::atomic<uint32_t> space_signal;
+	std::atomic<uint32_t> space_waiters;
+};
+
+struct shared_ring_data {
+	std::shared_ptr<void> view = nullptr;
+#ifdef _WIN32
+	std::shared_ptr<void> section     = nullptr;
+	std::shared_ptr<void> data_event  = nullptr;
+	std::shared_ptr<void> space_event = nullptr;
+#endif
+};
+
+static void* event(std::shared_ptr<void> const& internal_data, [[maybe_unused]] bool space)
+{
+#ifdef _WIN32
+	auto id = reinterpret_cast<shared_ring_data*>(internal_data.get());
+	return (space ? id->space_event : id->data_event).get();
+#else
+	(void)internal_data;
+	return nullptr;
+#endif
+}
+
+template<typename Predicate>
+static bool wait_on(std::atomic<uint32_t>& signal, std::atomic<uint32_t>& waiters, [[maybe_unused]] void* event, std::chrono::microseconds timeout, Predicate&& ready)
+{
+	auto deadline = std::chrono::steady_clock::now() + timeout;
+	bool result   = false;
+
+	// Registering as a waiter before checking the condition guarantees that the other side sees us, or we see its update.
+	waiters.fetch_add(1);
+	while (true) {
+		uint32_t value = signal.load();
+		if (ready()) {
+			result = true;
+			break;
+		}
+
+		auto now = std::chrono::steady_clock::now();
+		if (now >= deadline) {
+			break;
+		}
+		auto remaining = std::chrono::duration_cast<std::chrono::microseconds>(deadline - now);
+
+#if defined(_WIN32)
+		(void)value;
+		WaitForSingleObject(reinterpret_cast<HANDLE>(event), static_cast<DWORD>((remaining.count() + 999) / 1000));
+#elif defined(__linux__)
+		timespec ts = {};
+		ts.tv_sec   = static_cast<time_t>(remaining.count() / 1000000);
+		ts.tv_nsec  = static_cast<long>((remaining.count() % 1000000) * 1000);
+		syscall(SYS_futex, reinterpret_cast<uint32_t*>(&signal), FUTEX_WAIT, value, &ts, nullptr, 0);
+#else
+		(void)value;
+		std::this_thread::sleep_for(std::min(remaining, std::chrono::microseconds(100)));
+#endif
+	}
+	waiters.fetch_sub(1);
+
+	return result;
+}
+
+static void wake(std::atomic<uint32_t>& signal, std::atomic<uint32_t>& waiters, [[maybe_unused]] void* event)
+{
+	signal.fetch_add(1);
+
+	// Skip the system call entirely if nobody is waiting, which is the common case on the audio thread.
+	if (waiters.load() == 0) {
+		return;
+	}
+
+#if defined(_WIN32)
+	SetEvent(reinterpret_cast<HANDLE>(event));
+#elif defined(__linux__)
+	syscall(SYS_futex, reinterpret_cast<uint32_t*>(&signal), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#endif
+}
+
+template<typename T>
+tonplugins::memory::shared_ring<T>::shared_ring(std::string_view name, size_t elements) : _name(name), _owner(elements > 0), _header(nullptr), _buffer(nullptr), _size(0)
+{
+	if (_name.empty() || (_name.find_first_of("/\\") != std::string::npos)) {
+		throw std::invalid_argument("Shared ring buffer names must not be empty or contain path separators.");
+	}
+
+	auto id        = std::make_shared<shared_ring_data>();
+	_internal_data = id;
+
+	size_t total = _owner ? (header_size + elements * sizeof(T)) : 0;
+
+#ifdef _WIN32
+	std::wstring base = tonplugins::platform::utf8_to_wide(std::string("Local\\tonplugins-") + _name);
+
+	HANDLE section = nullptr;
+	if (_owner) {
+		SetLastError(ERROR_SUCCESS);
+		section = CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, static_cast<DWORD>((total >> 32) & 0xFFFFFFFFull), static_cast<DWORD>(total & 0xFFFFFFFFull), base.c_str());
+		if (section && (GetLastError() == ERROR_ALREADY_EXISTS)) {
+			// Sections live as long as anyone holds a handle, so a stale one can't be replaced.
+			CloseHandle(section);
+			throw std::runtime_error("A shared ring buffer with this name is still in use.");
+		}
+	} else {
+		section = OpenFileMappingW(FILE_MAP_ALL_ACCESS, FALSE, base.c_str());
+	}
+	if (!section) {
+		CLOG_THIS("%s failed with error code %ld.", _owner ? "CreateFileMappingW" : "OpenFileMappingW", GetLastError());
+		throw std::runtime_error("Failed to map shared ring buffer.");
+	}
+	id->section = std::shared_ptr<void>{section, [](void* ptr) { CloseHandle(ptr); }};
+
+	void* view = MapViewOfFile(section, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+	if (!view) {
+		CLOG_THIS("MapViewOfFile failed with error code %ld.", GetLastError());
+		throw std::runtime_error("Failed to map shared ring buffer.");
+	}
+	id->view = std::shared_ptr<void>{view, [](void* ptr) { UnmapViewOfFile(ptr); }};
+
+	// Auto-reset events, created by whichever side gets there first.
+	for (size_t idx = 0; idx < 2; idx++) {
+		std::wstring event_name = base + (idx ? L"-space" : L"-data");
+		HANDLE       event      = CreateEventW(nullptr, FALSE, FALSE, event_name.c_str());
+		if (!event) {
+			CLOG_THIS("CreateEventW failed with error code %ld.", GetLastError());
+			throw std::runtime_error("Failed to create shared ring buffer events.");
+		}
+		(idx ? id->space_event : id->data_event) = std::shared_ptr<void>{event, [](void* ptr) { CloseHandle(ptr); }};
+	}
+
+	if (!_owner) {
+		MEMORY_BASIC_INFORMATION info = {};
+		VirtualQuery(view, &info, sizeof(info));
+		total = static_cast<size_t>(info.RegionSize);
+	}
+#else
+	std::string path = std::string("/tonplugins-") + _name;
+
+	int fd = -1;
+	if (_owner) {
+		// Remove whatever a crashed previous owner left behind.
+		shm_unlink(path.c_str());
+		fd = shm_open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+	} else {
+		fd = shm_open(path.c_str(), O_RDWR, 0600);
+	}
+	if (fd == -1) {
+		CLOG_THIS("shm_open failed with error code %d.", errno);
+		throw std::runtime_error("Failed to map shared ring buffer.");
+	}
+	std::shared_ptr<void> file{reinterpret_cast<void*>(static_cast<intptr_t>(fd)), [](void* ptr) { close(static_cast<int>(reinterpret_cast<intptr_t>(ptr))); }};
+
+	if (_owner) {
+		if (ftruncate(fd, static_cast<off_t>(total)) != 0) {
+			CLOG_THIS("ftruncate failed with error code %d.", errno);
+			shm_unlink(path.c_str());
+			throw std::runtime_error("Failed to map shared ring buffer.");
+		}
+	} else {
+		struct stat info = {};
+		if (fstat(fd, &info) != 0) {
+			CLOG_THIS("fstat failed with error code %d.", errno);
+			throw std::runtime_error("Failed to map shared ring buffer.");
+		}
+		total = static_cast<size_t>(info.st_size);
+	}
+	if (total < header_size) {
+		throw std::runtime_error("Shared ring buffer is too small to be valid.");
+	}
+
+	void* view = mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (view == MAP_FAILED) {
+		CLOG_THIS("mmap failed with error code %d.", errno);
+		if (_owner) {
+			shm_unlink(path.c_str());
+		}
+		throw std::runtime_error("Failed to map shared ring buffer.");
+	}
+	id->view = std::shared_ptr<void>{view, [total](void* ptr) { munmap(ptr, total); }};
+#endif
+
+	_header = reinterpret_cast<header*>(id->view.get());
+	_buffer = reinterpret_cast<T*>(reinterpret_cast<uint8_t*>(id->view.get()) + header_size);
+
+	if (_owner) {
+		// Fresh mappings are zero-filled, so only the layout needs to be filled in. The magic value goes last, so the
+		// other side never sees a partially initialized header.
+		_size                  = elements;
+		_header->version       = version;
+		_header->element_size  = sizeof(T);
+		_header->capacity      = elements;
+		_header->magic.store(magic, std::memory_order_release);
+	} else {
+		if (_header->magic.load(std::memory_order_acquire) != magic) {
+			throw std::runtime_error("Shared ring buffer is not initialized or not a ring buffer.");
+		}
+		if ((_header->version != version) || (_header->element_size != sizeof(T))) {
+			CLOG_THIS("Expected version %" PRIu32 " with %zu byte elements, found version %" PRIu32 " with %" PRIu32 " byte elements.", version, sizeof(T), _header->version, _header->element_size);
+			throw std::runtime_error("Shared ring buffer has an incompatible layout.");
+		}
+		_size = static_cast<size_t>(_header->capacity);
+		if ((_size == 0) || (total < (header_size + _size * sizeof(T)))) {
+			throw std::runtime_error("Shared ring buffer is truncated.");
+		}
+	}
+}
+
+template<typename T>
+tonplugins::memory::shared_ring<T>::~shared_ring()
+{
+#ifndef _WIN32
+	// The name goes away now, while the memory stays valid until the other side unmaps it too.
+	if (_owner) {
+		shm_unlink((std::string("/tonplugins-") + _name).c_str());
+	}
+#endif
+}
+
+template<typename T>
+std::string_view tonplugins::memory::shared_ring<T>::name() const
+{
+	return _name;
+}
+
+template<typename T>
+size_t tonplugins::memory::shared_ring<T>::size() const
+{
+	return _size;
+}
+
+template<typename T>
+size_t tonplugins::memory::shared_ring<T>::used() const
+{
+	return static_cast<size_t>(_header->write_pos.load(std::memory_order_acquire) - _header->read_pos.load(std::memory_order_acquire));
+}
+
+template<typename T>
+size_t tonplugins::memory::shared_ring<T>::free() const
+{
+	return _size - used();
+}
+
+template<typename T>
+size_t tonplugins::memory::shared_ring<T>::write(size_t size, T const* buffer)
+{
+	uint64_t write_pos = _header->write_pos.load(std::memory_order_relaxed);
+	uint64_t read_pos  = _header->read_pos.load(std::memory_order_acquire);
+	size_t   elements  = std::min(size, _size - static_cast<size_t>(write_pos - read_pos));
+	if (elements == 0) {
+		return 0;
+	}
+
+	// Copy in up to two parts, as the buffer isn't mirrored.
+	size_t offset = static_cast<size_t>(write_pos % _size);
+	size_t first  = std::min(elements, _size - offset);
+	memcpy(_buffer + offset, buffer, sizeof(T) * first);
+	memcpy(_buffer, buffer + first, sizeof(T) * (elements - first));
+
+	_header->write_pos.store(write_pos + elements, std::memory_order_release);
+	wake(_header->data_signal, _header->data_waiters, event(_internal_data, false));
+
+	return elements;
+}
+
+template<typename T>
+size_t tonplugins::memory::shared_ring<T>::read(size_t size, T* buffer)
+{
+	uint64_t read_pos  = _header->read_pos.load(std::memory_order_relaxed);
+	uint64_t write_pos = _header->write_pos.load(std::memory_order_acquire);
+	size_t   elements  = std::min(size, static_cast<size_t>(write_pos - read_pos));
+	if (elements == 0) {
+		return 0;
+	}
+
+	if (buffer) {
+		size_t offset = static_cast<size_t>(read_pos % _size);
+		size_t first  = std::min(elements, _size - offset);
+		memcpy(buffer, _buffer + offset, sizeof(T) * first);
+		memcpy(buffer + first, _buffer, sizeof(T) * (elements - first));
+	}
+
+	_header->read_pos.store(read_pos + elements, std::memory_order_release);
+	wake(_header->space_signal, _header->space_waiters, event(_internal_data, true));
+
+	return elements;
+}
+
+template<typename T>
+bool tonplugins::memory::shared_ring<T>::wait_for_data(size_t size, std::chrono::microseconds timeout)
+{
+	return wait_on(_header->data_signal, _header->data_waiters, event(_internal_data, false), timeout, [this, size]() { return used() >= size; });
+}
+
+template<typename T>
+bool tonplugins::memory::shared_ring<T>::wait_for_space(size_t size, std::chrono::microseconds timeout)
+{
+	return wait_on(_header->space_signal, _header->space_waiters, event(_internal_data, true), timeout, [this, size]() { return free() >= size; });
+}
+
+template class tonplugins::memory::shared_ring<float>;
+template class tonplugins::memory::shared_ring<double>;
+template class tonplugins::memory::shared_ring<int16_t>;
+template class tonplugins::memory::shared_ring<int32_t>;
+template class tonplugins::memory::shared_ring<uint8_t>;
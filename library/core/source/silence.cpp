@@ -0,0 +1,126 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#include "silence.hpp"
+#include "simd.hpp"
+
+#include "warning-disable.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "warning-enable.hpp"
+
+template<typename T>
+bool tonplugins::silence::is_silent(T const* data, size_t samples, T threshold)
+{
+	typedef tonplugins::simd::native_t<T> vec_t;
+	constexpr size_t                      unroll = 4;
+	constexpr size_t                      stride = vec_t::width * unroll;
+
+	size_t idx = 0;
+
+	// Check a few vectors at a time, and only branch once per group.
+	for (; (idx + stride) <= samples; idx += stride) {
+		vec_t v0 = tonplugins::simd::abs(vec_t::load(data + idx));
+		vec_t v1 = tonplugins::simd::abs(vec_t::load(data + idx + vec_t::width));
+		vec_t v2 = tonplugins::simd::abs(vec_t::load(data + idx + vec_t::width * 2));
+		vec_t v3 = tonplugins::simd::abs(vec_t::load(data + idx + vec_t::width * 3));
+		vec_t m  = tonplugins::simd::max(tonplugins::simd::max(v0, v1), tonplugins::simd::max(v2, v3));
+		if (tonplugins::simd::hmax(m) > threshold) {
+			return false;
+		}
+	}
+
+	for (; idx < samples; idx++) {
+		if (std::fabs(data[idx]) > threshold) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+template<typename T>
+void tonplugins::silence::clear(T* const* data, size_t channels, size_t samples)
+{
+	for (size_t idx = 0; idx < channels; idx++) {
+		memset(data[idx], 0, sizeof(T) * samples);
+	}
+}
+
+tonplugins::silence::gate::gate(size_t tail, float threshold) : _tail(tail), _remaining(0), _threshold(threshold), _silent(false)
+{
+	reset();
+}
+
+tonplugins::silence::gate::~gate() = default;
+
+void tonplugins::silence::gate::set_tail(size_t tail)
+{
+	_tail = tail;
+
+	// Never cut off a tail which is already ringing out.
+	if (!_silent) {
+		_remaining = std::max(_remaining, tail);
+	}
+}
+
+size_t tonplugins::silence::gate::tail() const
+{
+	return _tail;
+}
+
+void tonplugins::silence::gate::reset()
+{
+	_remaining = _tail;
+	_silent    = false;
+}
+
+template<typename T>
+bool tonplugins::silence::gate::update(T const* const* data, size_t channels, size_t samples, uint64_t silence_flags)
+{
+	bool silent = true;
+	for (size_t idx = 0; silent && (idx < channels); idx++) {
+		if ((idx < 64) && (silence_flags & (1ull << idx))) {
+			continue;
+		}
+		silent = tonplugins::silence::is_silent(data[idx], samples, static_cast<T>(_threshold));
+	}
+
+	if (!silent) {
+		// Audible input, re-arm the tail.
+		_remaining = _tail;
+		_silent    = false;
+	} else if (_tail == infinite_tail) {
+		_silent = false;
+	} else if (_remaining > 0) {
+		// Silent input, but the effect is still ringing out.
+		_remaining -= std::min(_remaining, samples);
+		_silent = false;
+	} else {
+		_silent = true;
+	}
+
+	return !_silent;
+}
+
+bool tonplugins::silence::gate::is_silent() const
+{
+	return _silent;
+}
+
+uint64_t tonplugins::silence::gate::silence_flags(size_t channels) const
+{
+	if (!_silent) {
+		return 0;
+	}
+	return (channels >= 64) ? ~0ull : ((1ull << channels) - 1);
+}
+
+template bool tonplugins::silence::is_silent<float>(float const*, size_t, float);
+template bool tonplugins::silence::is_silent<double>(double const*, size_t, double);
+template void tonplugins::silence::clear<float>(float* const*, size_t, size_t);
+template void tonplugins::silence::clear<double>(double* const*, size_t, size_t);
+template bool tonplugins::silence::gate::update<float>(float const* const*, size_t, size_t, uint64_t);
+template bool tonplugins::silence::gate::update<double>(double const* const*, size_t, size_t, uint64_t);
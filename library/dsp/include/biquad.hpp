@@ -0,0 +1,93 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#pragma once
+#include "aligned.hpp"
+
+#include "warning-disable.hpp"
+#include <cinttypes>
+#include <cstddef>
+#include "warning-enable.hpp"
+
+namespace tonplugins::dsp {
+
+	/** Normalized coefficients of a single second order section, with a0 = 1.
+	 *
+	 * The factory functions follow the "Audio EQ Cookbook" by Robert Bristow-Johnson.
+	 */
+	template<typename T>
+	struct biquad_coefficients {
+		T b0 = 1;
+		T b1 = 0;
+		T b2 = 0;
+		T a1 = 0;
+		T a2 = 0;
+
+		static biquad_coefficients<T> lowpass(double sample_rate, double frequency, double q);
+		static biquad_coefficients<T> highpass(double sample_rate, double frequency, double q);
+		static biquad_coefficients<T> bandpass(double sample_rate, double frequency, double q);
+		static biquad_coefficients<T> notch(double sample_rate, double frequency, double q);
+		static biquad_coefficients<T> allpass(double sample_rate, double frequency, double q);
+		static biquad_coefficients<T> peak(double sample_rate, double frequency, double q, double gain_db);
+		static biquad_coefficients<T> lowshelf(double sample_rate, double frequency, double q, double gain_db);
+		static biquad_coefficients<T> highshelf(double sample_rate, double frequency, double q, double gain_db);
+	};
+
+	/** Multichannel cascade of biquad filters in transposed direct form II.
+	 *
+	 * Channels are packed into the lanes of the vector unit, so four (float) or two (double) channels are filtered at
+	 * the cost of one. Every channel may use its own coefficients. Audio is processed in place, in chunks of at most
+	 * chunk_size samples, through a small interleaved scratch buffer allocated up front.
+	 */
+	template<typename T>
+	class biquad {
+		public:
+		static constexpr size_t chunk_size = 256;
+
+		private:
+		size_t _channels;
+		size_t _stages;
+		size_t _groups;
+		size_t _width;
+
+		// [group][stage][b0, b1, b2, a1, a2][lane]
+		tonplugins::memory::aligned_vector<T> _coefficients;
+		// [group][stage][s1, s2][lane]
+		tonplugins::memory::aligned_vector<T> _state;
+		// [sample][lane]
+		tonplugins::memory::aligned_vector<T> _scratch;
+
+		public:
+		/** Create a new cascade, initially passing audio through unchanged.
+		 *
+		 * @argument channels Number of channels to filter.
+		 * @argument stages Number of second order sections per channel.
+		 */
+		biquad(size_t channels, size_t stages);
+		~biquad();
+
+		size_t channels() const;
+		size_t stages() const;
+
+		/** Update the coefficients of one section of one channel.
+		 */
+		void set(size_t stage, size_t channel, biquad_coefficients<T> const& coefficients);
+
+		/** Update the coefficients of one section of all channels.
+		 */
+		void set(size_t stage, biquad_coefficients<T> const& coefficients);
+
+		/** Clear the filter state.
+		 */
+		void reset();
+
+		/** Filter audio in place.
+		 *
+		 * @argument data Pointers to each channel, at least channels() of them.
+		 * @argument samples Number of samples per channel.
+		 */
+		void process(T* const* data, size_t samples);
+	};
+
+} // namespace tonplugins::dsp
@@ -0,0 +1,232 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#pragma once
+#include "warning-disable.hpp"
+#include <concepts>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "warning-enable.hpp"
+
+namespace tonplugins::dsp {
+
+	/** Sample precision requested by the host, for example ProcessSetup::symbolicSampleSize in VST3.
+	 */
+	enum class precision {
+		single, // 32-bit float
+		double_, // 64-bit float
+	};
+
+	/** Fixed sequence of processing stages, for one sample type.
+	 *
+	 * Each stage is a class template over the sample type, with process(T* const* data, size_t samples) working in
+	 * place, such as biquad or fir. Stages are called in order through their concrete types, so there is no virtual
+	 * call or branch on the sample type anywhere inside the chain, and the compiler is free to inline all of it.
+	 *
+	 * Stages that have reset() or an integer latency() take part in reset() and latency() of the chain.
+	 */
+	template<typename T, template<typename> class... Stages>
+	class chain {
+		std::tuple<std::unique_ptr<Stages<T>>...> _stages;
+
+		public:
+		typedef T sample_t;
+
+		static constexpr size_t size = sizeof...(Stages);
+
+		/** Create every stage.
+		 *
+		 * @argument args One tuple of constructor arguments per stage, in order, for example std::forward_as_tuple(2, 4).
+		 */
+		template<typename... Arguments>
+		chain(Arguments&&... args) : _stages(make_stage<Stages<T>>(std::forward<Arguments>(args))...)
+		{
+			static_assert(sizeof...(Arguments) == sizeof...(Stages), "Every stage needs a tuple of constructor arguments.");
+		}
+
+		template<size_t Index>
+		auto& get()
+		{
+			return *std::get<Index>(_stages);
+		}
+
+		/** Sum of the latency of all stages, in samples.
+		 */
+		size_t latency() const
+		{
+			return std::apply(
+				[](auto const&... stage) {
+					size_t total = 0;
+					((total += stage_latency(*stage)), ...);
+					return total;
+				},
+				_stages);
+		}
+
+		void reset()
+		{
+			std::apply([](auto&... stage) { (stage_reset(*stage), ...); }, _stages);
+		}
+
+		/** Run all stages on a block, in place.
+		 */
+		void process(T* const* data, size_t samples)
+		{
+			std::apply([data, samples](auto&... stage) { (stage->process(data, samples), ...); }, _stages);
+		}
+
+		private:
+		template<typename Stage, typename Tuple>
+		static std::unique_ptr<Stage> make_stage(Tuple&& args)
+		{
+			return std::apply([](auto&&... values) { return std::make_unique<Stage>(std::forward<decltype(values)>(values)...); }, std::forward<Tuple>(args));
+		}
+
+		template<typename Stage>
+		static size_t stage_latency(Stage const& stage)
+		{
+			if constexpr (requires { { stage.latency() } -> std::same_as<size_t>; }) {
+				return stage.latency();
+			} else {
+				return 0;
+			}
+		}
+
+		template<typename Stage>
+		static void stage_reset(Stage& stage)
+		{
+			if constexpr (requires { stage.reset(); }) {
+				stage.reset();
+			}
+		}
+	};
+
+	/** Holds a processing chain in whichever precision the host asked for, and dispatches once per block.
+	 *
+	 * Chain is any class template over the sample type with a constructor and process(T* const* data, size_t samples),
+	 * such as an alias of chain. Both the float and the double version are compiled from the same source, but only the
+	 * active one is ever constructed. So a 64-bit host gets a native double path, and choosing it costs a single branch
+	 * per block instead of conversions or branches per sample.
+	 */
+	template<template<typename> class Chain>
+	class dispatch {
+		precision                      _precision = precision::single;
+		std::unique_ptr<Chain<float>>  _single;
+		std::unique_ptr<Chain<double>> _double;
+
+		public:
+		/** (Re-)create the chain, for example from setupProcessing().
+		 *
+		 * @argument mode Precision to process in from now on.
+		 * @argument args Arguments passed on to the constructor of the chain. Both versions are compiled with them, so keep
+		 *                them independent of the sample type, such as channel counts and sample rates.
+		 */
+		template<typename... Arguments>
+		void configure(precision mode, Arguments&&... args)
+		{
+			_single.reset();
+			_double.reset();
+			_precision = mode;
+			if (mode == precision::double_) {
+				_double = std::make_unique<Chain<double>>(std::forward<Arguments>(args)...);
+			} else {
+				_single = std::make_unique<Chain<float>>(std::forward<Arguments>(args)...);
+			}
+		}
+
+		bool configured() const
+		{
+			return _single || _double;
+		}
+
+		precision active() const
+		{
+			return _precision;
+		}
+
+		/** The chain for a sample type, or nullptr if it is not the active one.
+		 */
+		template<typename T>
+		Chain<T>* get()
+		{
+			if constexpr (std::is_same_v<T, double>) {
+				return _double.get();
+			} else {
+				return _single.get();
+			}
+		}
+
+		/** Call a generic callable with the active chain.
+		 *
+		 * @argument callback Callable as callback(Chain<T>& chain) for both float and double.
+		 * @throws std::logic_error if configure() hasn't been called yet.
+		 */
+		template<typename Callback>
+		decltype(auto) visit(Callback&& callback)
+		{
+			if (!configured()) {
+				throw std::logic_error("Processing chain has not been configured.");
+			}
+			if (_precision == precision::double_) {
+				return callback(*_double);
+			} else {
+				return callback(*_single);
+			}
+		}
+
+		/** Process a block of single precision audio.
+		 *
+		 * @argument data Pointers to each channel, for example AudioBusBuffers::channelBuffers32 in VST3.
+		 * @argument samples Number of samples per channel.
+		 * @throws std::logic_error if configure() hasn't been called yet, or the active precision is double.
+		 */
+		void process(float* const* data, size_t samples)
+		{
+			if (!_single) {
+				throw std::logic_error("Processing chain is not configured for single precision.");
+			}
+			_single->process(data, samples);
+		}
+
+		/** Process a block of double precision audio.
+		 *
+		 * @argument data Pointers to each channel, for example AudioBusBuffers::channelBuffers64 in VST3.
+		 * @argument samples Number of samples per channel.
+		 * @throws std::logic_error if configure() hasn't been called yet, or the active precision is single.
+		 */
+		void process(double* const* data, size_t samples)
+		{
+			if (!_double) {
+				throw std::logic_error("Processing chain is not configured for double precision.");
+			}
+			_double->process(data, samples);
+		}
+
+		/** Process a block in the active precision, for hosts that only hand out untyped channel pointers.
+		 *
+		 * Typed channel pointers don't convert to void* const*, so prefer the float and double overloads above. Use this
+		 * only with pointers that are already untyped, or after an explicit cast.
+		 *
+		 * @argument data Channel pointers in the active precision.
+		 * @argument samples Number of samples per channel.
+		 * @throws std::logic_error if configure() hasn't been called yet.
+		 */
+		void process(void* const* data, size_t samples)
+		{
+			if (!configured()) {
+				throw std::logic_error("Processing chain has not been configured.");
+			}
+			if (_precision == precision::double_) {
+				_double->process(reinterpret_cast<double* const*>(data), samples);
+			} else {
+				_single->process(reinterpret_cast<float* const*>(data), samples);
+			}
+		}
+	};
+
+} // namespace tonplugins::dsp
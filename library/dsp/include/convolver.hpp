@@ -0,0 +1,134 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#pragma once
+#include "aligned.hpp"
+#include "fft.hpp"
+
+#include "warning-disable.hpp"
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "warning-enable.hpp"
+
+namespace tonplugins::dsp {
+
+	/** Uniformly partitioned FFT convolution (overlap-save with a frequency-domain delay line).
+	 *
+	 * Processes exactly partition() samples per call, and adds no latency beyond that. The impulse response is split
+	 * into partitions of the same size, whose spectra are computed once up front.
+	 *
+	 * Construction allocates and transforms the whole impulse response, so build new convolvers away from the audio
+	 * thread and swap them in, for example through tonplugins::memory::exchange.
+	 */
+	template<typename T>
+	class uniform_convolver {
+		size_t _partition;
+		size_t _bins;
+		size_t _partitions;
+		size_t _position;
+
+		std::shared_ptr<tonplugins::dsp::fft<T>> _fft;
+
+		// [partition][bin]
+		tonplugins::memory::aligned_vector<T> _ir_re;
+		tonplugins::memory::aligned_vector<T> _ir_im;
+		tonplugins::memory::aligned_vector<T> _fdl_re;
+		tonplugins::memory::aligned_vector<T> _fdl_im;
+
+		tonplugins::memory::aligned_vector<T> _input;
+		tonplugins::memory::aligned_vector<T> _output;
+		tonplugins::memory::aligned_vector<T> _acc_re;
+		tonplugins::memory::aligned_vector<T> _acc_im;
+
+		public:
+		/** Create a new convolver.
+		 *
+		 * @argument ir The impulse response.
+		 * @argument length Length of the impulse response in samples.
+		 * @argument partition Partition size in samples, must be a power of two.
+		 */
+		uniform_convolver(T const* ir, size_t length, size_t partition);
+		~uniform_convolver();
+
+		size_t partition() const;
+
+		/** Clear all input history.
+		 */
+		void reset();
+
+		/** Convolve one partition of input.
+		 *
+		 * @argument input partition() samples of input.
+		 * @argument output Receives partition() samples of output, may be the same as input.
+		 */
+		void process(T const* input, T* output);
+	};
+
+	/** Non-uniformly partitioned FFT convolution for long impulse responses, at arbitrary block sizes.
+	 *
+	 * The head of the impulse response is convolved with small partitions for low latency, while later parts use
+	 * progressively larger partitions (four times the previous size, up to a limit), which greatly reduces the cost
+	 * per sample for impulse responses of several seconds. Short impulse responses end up in a single uniformly
+	 * partitioned segment.
+	 *
+	 * Input is buffered into blocks of block() samples, so the total latency is exactly latency() samples regardless of
+	 * how the host splits its blocks.
+	 */
+	template<typename T>
+	class convolver {
+		struct segment {
+			std::unique_ptr<uniform_convolver<T>> engine;
+			size_t                                offset;
+			size_t                                fill;
+			tonplugins::memory::aligned_vector<T> input;
+			tonplugins::memory::aligned_vector<T> output;
+		};
+
+		size_t _block;
+		size_t _fill;
+		size_t _cursor;
+
+		std::vector<segment> _segments;
+
+		tonplugins::memory::aligned_vector<T> _input;
+		tonplugins::memory::aligned_vector<T> _output;
+		tonplugins::memory::aligned_vector<T> _accumulator;
+
+		public:
+		/** Create a new convolver.
+		 *
+		 * @argument ir The impulse response.
+		 * @argument length Length of the impulse response in samples.
+		 * @argument block Smallest partition size, and the resulting latency. Rounded up to a power of two.
+		 * @argument max_partition Largest partition size used for the tail of the impulse response.
+		 */
+		convolver(T const* ir, size_t length, size_t block = 256, size_t max_partition = 8192);
+		~convolver();
+
+		/** Latency in samples added by process().
+		 */
+		size_t latency() const;
+
+		/** Size of the smallest partition.
+		 */
+		size_t block() const;
+
+		/** Clear all input history and pending output.
+		 */
+		void reset();
+
+		/** Convolve input of arbitrary length.
+		 *
+		 * @argument input Input samples.
+		 * @argument output Receives output samples, may be the same as input.
+		 * @argument samples Number of samples.
+		 */
+		void process(T const* input, T* output, size_t samples);
+
+		private:
+		void process_block();
+	};
+
+} // namespace tonplugins::dsp
@@ -0,0 +1,79 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#pragma once
+#include "aligned.hpp"
+
+#include "warning-disable.hpp"
+#include <cinttypes>
+#include <memory>
+#include <vector>
+#include "warning-enable.hpp"
+
+namespace tonplugins::dsp {
+
+	/** Real-valued FFT of a fixed power-of-two size, with split-complex spectra.
+	 *
+	 * A plan only holds read-only tables and no scratch memory, so a single plan is safe to use from any number of
+	 * threads at once. Use get() to share plans between all instances in the process.
+	 *
+	 * Spectra are stored as two separate arrays of size()/2 + 1 elements, holding the real and imaginary parts of
+	 * bins 0 (DC) through size()/2 (Nyquist).
+	 */
+	template<typename T>
+	class fft {
+		size_t _size;
+		size_t _half;
+
+		std::vector<uint32_t>                  _bitreverse;
+		tonplugins::memory::aligned_vector<T> _stage_re;
+		tonplugins::memory::aligned_vector<T> _stage_im;
+		tonplugins::memory::aligned_vector<T> _real_re;
+		tonplugins::memory::aligned_vector<T> _real_im;
+
+		public:
+		/** Create a new plan, prefer get() over this.
+		 *
+		 * @argument size Transform size in samples, must be a power of two and at least 4.
+		 */
+		fft(size_t size);
+		~fft();
+
+		/** Transform size in samples.
+		 */
+		size_t size() const;
+
+		/** Number of bins in a spectrum, size()/2 + 1.
+		 */
+		size_t bins() const;
+
+		/** Forward transform.
+		 *
+		 * @argument input size() real samples.
+		 * @argument re Receives bins() real parts.
+		 * @argument im Receives bins() imaginary parts.
+		 */
+		void forward(T const* input, T* re, T* im) const;
+
+		/** Inverse transform, without normalization.
+		 *
+		 * The result is scaled by size(), callers fold 1/size() into their own gains. The spectrum is used as scratch
+		 * memory and is destroyed.
+		 *
+		 * @argument re bins() real parts.
+		 * @argument im bins() imaginary parts.
+		 * @argument output Receives size() real samples.
+		 */
+		void inverse(T* re, T* im, T* output) const;
+
+		public:
+		/** Retrieve a shared plan for the given size.
+		 */
+		static std::shared_ptr<fft<T>> get(size_t size);
+
+		private:
+		void transform(T* re, T* im) const;
+	};
+
+} // namespace tonplugins::dsp
@@ -0,0 +1,66 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#pragma once
+#include "aligned.hpp"
+
+#include "warning-disable.hpp"
+#include <cstddef>
+#include <vector>
+#include "warning-enable.hpp"
+
+namespace tonplugins::dsp {
+
+	/** Multichannel direct-form FIR filter for short kernels.
+	 *
+	 * Every output sample is a single vectorized dot product over a contiguous window of the input history, which is
+	 * faster than FFT convolution for kernels up to a few hundred taps. Use convolver for anything longer.
+	 */
+	template<typename T>
+	class fir {
+		public:
+		static constexpr size_t chunk_size = 256;
+
+		private:
+		size_t _channels;
+		size_t _taps;
+
+		// Kernel in reverse order, padded with zeros to a multiple of the vector width.
+		tonplugins::memory::aligned_vector<T> _kernel;
+		// [channel][padding + history + chunk]
+		std::vector<tonplugins::memory::aligned_vector<T>> _history;
+
+		public:
+		/** Create a new filter.
+		 *
+		 * @argument channels Number of channels to filter.
+		 * @argument kernel The impulse response.
+		 * @argument taps Length of the impulse response.
+		 */
+		fir(size_t channels, T const* kernel, size_t taps);
+		~fir();
+
+		size_t channels() const;
+		size_t taps() const;
+
+		/** Replace the kernel with one of the same length.
+		 */
+		void set(T const* kernel);
+
+		/** Clear the input history.
+		 */
+		void reset();
+
+		/** Filter audio in place.
+		 *
+		 * @argument data Pointers to each channel, at least channels() of them.
+		 * @argument samples Number of samples per channel.
+		 */
+		void process(T* const* data, size_t samples);
+
+		private:
+		size_t padded_taps() const;
+	};
+
+} // namespace tonplugins::dsp
@@ -0,0 +1,140 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#pragma once
+#include "aligned.hpp"
+#include "arena.hpp"
+
+#include "warning-disable.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "warning-enable.hpp"
+
+namespace tonplugins::dsp {
+
+	/** Multichannel 2x to 16x oversampling for nonlinear processing.
+	 *
+	 * Each doubling is one half-band filter, split into its two polyphase components, so every filter runs at the lower
+	 * of its two rates and only ever computes samples that are kept. The first stage has the steepest transition band;
+	 * later stages only have to reject images far away from the audio band and are much shorter. Filters are designed
+	 * once per stage, quality and mode, and shared through core::cached() between all instances in the process for as
+	 * long as any of them exists.
+	 *
+	 * Linear-phase filters keep the half-band structure, where one polyphase component is a single tap, and introduce
+	 * an exact, whole-sample latency. Minimum-phase filters trade that for a much lower latency, with phase shift near
+	 * the top of the audio band; latency() is then their group delay at low frequencies.
+	 *
+	 * All state lives in a per-instance arena, so a single oversampler touches one contiguous block of memory.
+	 */
+	template<typename T>
+	class oversampler {
+		public:
+		enum class quality {
+			low, // 80% of the bandwidth, 60 dB rejection.
+			medium, // 88% of the bandwidth, 90 dB rejection.
+			high, // 92% of the bandwidth, 120 dB rejection.
+		};
+
+		enum class mode {
+			linear_phase,
+			minimum_phase,
+		};
+
+		struct halfband {
+			size_t taps; // Per phase, padded to the vector width.
+			bool   sparse; // Second phase is a single tap of 0.5, at center.
+			size_t center;
+			double delay; // Group delay in samples at the higher rate.
+
+			// [phase][tap], each phase in reverse order.
+			tonplugins::memory::aligned_vector<T> coefficients;
+		};
+
+		private:
+		size_t _channels;
+		size_t _factor;
+		size_t _stages;
+		size_t _max_block;
+		size_t _latency;
+		size_t _padding; // In samples at the highest rate, makes up the rest of the latency to a whole sample.
+
+		std::vector<std::shared_ptr<halfband const>> _filters;
+
+		tonplugins::memory::arena _arena;
+		// [stage][channel]
+		std::vector<T*> _buffers; // Output of each upsampling stage, and input of the matching downsampling stage.
+		std::vector<T*> _up;
+		std::vector<T*> _even;
+		std::vector<T*> _odd;
+		// [channel]
+		std::vector<T*> _delay;
+		std::vector<T*> _targets;
+
+		public:
+		/** Create a new oversampler.
+		 *
+		 * @argument channels Number of channels.
+		 * @argument factor Oversampling factor, one of 2, 4, 8 or 16.
+		 * @argument level Trade-off between CPU usage, pass-band width and image rejection.
+		 * @argument response Linear or minimum phase filters.
+		 * @argument max_block Largest number of samples per call to upsample() and downsample().
+		 */
+		oversampler(size_t channels, size_t factor, quality level = quality::medium, mode response = mode::linear_phase, size_t max_block = 1024);
+		~oversampler();
+
+		size_t channels() const;
+		size_t factor() const;
+
+		/** Total latency of upsampling and downsampling in samples at the original rate, report this to the host.
+		 */
+		size_t latency() const;
+
+		/** Clear all filter state.
+		 */
+		void reset();
+
+		/** Upsample a block.
+		 *
+		 * @argument input Pointers to each input channel.
+		 * @argument samples Number of samples per channel, at most max_block.
+		 * @return Pointers to each channel at the higher rate, with samples * factor() samples each. They stay valid until
+		 *         the next call to upsample(), and are meant to be processed in place.
+		 */
+		T* const* upsample(T const* const* input, size_t samples);
+
+		/** Downsample the block returned by the last call to upsample().
+		 *
+		 * @argument output Pointers to each output channel, may be the same as the input given to upsample().
+		 * @argument samples Number of samples per channel at the original rate, same as given to upsample().
+		 */
+		void downsample(T* const* output, size_t samples);
+
+		/** Run a callback at the higher rate on audio of any length, in place.
+		 *
+		 * @argument data Pointers to each channel.
+		 * @argument samples Number of samples per channel.
+		 * @argument callback Callable as callback(T* const* data, size_t samples), at the higher rate.
+		 */
+		template<typename Callback>
+		void process(T* const* data, size_t samples, Callback&& callback)
+		{
+			for (size_t offset = 0; offset < samples; offset += _max_block) {
+				size_t length = std::min(_max_block, samples - offset);
+				for (size_t channel = 0; channel < _channels; channel++) {
+					_targets[channel] = data[channel] + offset;
+				}
+
+				T* const* oversampled = upsample(_targets.data(), length);
+				callback(oversampled, length * _factor);
+				downsample(_targets.data(), length);
+			}
+		}
+
+		private:
+		static std::shared_ptr<halfband const> design(size_t stage, quality level, mode response);
+	};
+
+} // namespace tonplugins::dsp
@@ -0,0 +1,119 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#pragma once
+#include "aligned.hpp"
+#include "ringbuffer.hpp"
+
+#include "warning-disable.hpp"
+#include <cinttypes>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "warning-enable.hpp"
+
+namespace tonplugins::dsp {
+
+	/** Streaming polyphase sample rate converter for rational ratios.
+	 *
+	 * Converts by an exact ratio of L/M, derived from the input and output sample rates. Every output sample is one
+	 * vectorized dot product between the recent input and one phase of a windowed-sinc filter bank. Filter banks are
+	 * designed once per ratio and quality, and shared between all instances in the process.
+	 *
+	 * The latency is a constant, known up front, so plugins can wrap fixed-rate engines (for example 48 kHz neural
+	 * models) and report exact latency to the host.
+	 */
+	template<typename T>
+	class resampler {
+		public:
+		enum class quality {
+			low,
+			medium,
+			high,
+		};
+
+		struct filter_bank {
+			size_t interpolation; // L
+			size_t decimation; // M
+			size_t taps; // Per phase, padded to the vector width.
+			double delay; // Group delay in input samples.
+
+			// [phase][tap], each phase in reverse order.
+			tonplugins::memory::aligned_vector<T> coefficients;
+		};
+
+		static constexpr size_t chunk_size = 256;
+
+		private:
+		size_t _channels;
+		size_t _phase;
+
+		std::shared_ptr<filter_bank const> _bank;
+
+		// [channel][history + chunk]
+		std::vector<tonplugins::memory::aligned_vector<T>> _history;
+		std::vector<T const*>                              _sources;
+		std::vector<T*>                                    _targets;
+
+		public:
+		/** Create a new resampler.
+		 *
+		 * @argument channels Number of channels to convert.
+		 * @argument input_rate Sample rate of the input.
+		 * @argument output_rate Sample rate of the output.
+		 * @argument level Trade-off between CPU usage, pass-band width and stop-band attenuation.
+		 */
+		resampler(size_t channels, uint32_t input_rate, uint32_t output_rate, quality level = quality::medium);
+		~resampler();
+
+		size_t channels() const;
+
+		/** Conversion ratio as L/M, output samples per input samples.
+		 */
+		size_t interpolation() const;
+		size_t decimation() const;
+
+		/** Latency in output samples, constant for the lifetime of the resampler.
+		 */
+		double latency() const;
+
+		/** Latency in input samples, constant for the lifetime of the resampler.
+		 */
+		double input_latency() const;
+
+		/** Largest number of output samples produced for the given number of input samples.
+		 */
+		size_t maximum_output(size_t input) const;
+
+		/** Clear all history.
+		 */
+		void reset();
+
+		/** Convert a block of samples.
+		 *
+		 * All input is consumed.
+		 *
+		 * @argument input Pointers to each input channel.
+		 * @argument samples Number of input samples per channel.
+		 * @argument output Pointers to each output channel, with room for at least maximum_output(samples) samples.
+		 * @return Number of samples written to each output channel.
+		 */
+		size_t process(T const* const* input, size_t samples, T* const* output);
+
+		/** Convert as much as possible from one set of ring buffers into another.
+		 *
+		 * Input is read straight from, and output is written straight into the mirrored ring buffer memory. Only as much
+		 * input is consumed as the output rings have free space for.
+		 *
+		 * @argument input Ring buffer for each input channel.
+		 * @argument output Ring buffer for each output channel.
+		 * @return Number of samples written to each output channel.
+		 */
+		size_t process(tonplugins::memory::ring<T>* const* input, tonplugins::memory::ring<T>* const* output);
+
+		private:
+		static std::shared_ptr<filter_bank const> design(size_t interpolation, size_t decimation, quality level);
+	};
+
+} // namespace tonplugins::dsp
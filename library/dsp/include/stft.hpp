@@ -0,0 +1,124 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#pragma once
+#include "aligned.hpp"
+#include "fft.hpp"
+#include "reframer.hpp"
+#include "ringbuffer.hpp"
+
+#include "warning-disable.hpp"
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "warning-enable.hpp"
+
+namespace tonplugins::dsp {
+
+	/** Streaming short-time Fourier transform with weighted overlap-add resynthesis.
+	 *
+	 * Every hop() samples, the last frame() samples of each channel are windowed and transformed, handed to a callback
+	 * as split-complex spectra for all channels at once, then transformed back, windowed again and overlap-added into
+	 * the output. Host blocks of any size are re-framed through the mirrored ring buffers, so the analysis frame is
+	 * always read in place.
+	 *
+	 * The square root of the chosen window is used for both analysis and synthesis, normalized so that an untouched
+	 * spectrum reconstructs the input exactly. FFT plans and windows are shared through core::cached() between all
+	 * instances in the process, whether or not anyone holds on to the core, and freed once the last instance using them
+	 * is gone.
+	 */
+	template<typename T>
+	class stft {
+		public:
+		enum class window {
+			hann,
+			hamming,
+			blackman,
+			rectangular,
+		};
+
+		struct window_pair {
+			tonplugins::memory::aligned_vector<T> analysis;
+			tonplugins::memory::aligned_vector<T> synthesis; // Includes normalization and the inverse FFT's 1/size.
+		};
+
+		private:
+		size_t _channels;
+		size_t _frame;
+		size_t _hop;
+		size_t _bins;
+		size_t _stride; // Between the spectra of two channels, padded to keep each one aligned.
+
+		std::shared_ptr<tonplugins::dsp::fft<T>> _fft;
+		std::shared_ptr<window_pair const>       _window;
+
+		tonplugins::memory::reframer<T>                           _reframer;
+		std::vector<std::unique_ptr<tonplugins::memory::ring<T>>> _history;
+
+		// [channel][bin]
+		tonplugins::memory::aligned_vector<T> _re;
+		tonplugins::memory::aligned_vector<T> _im;
+		std::vector<T*>                       _re_ptrs;
+		std::vector<T*>                       _im_ptrs;
+
+		// [channel][sample]
+		tonplugins::memory::aligned_vector<T> _overlap;
+		tonplugins::memory::aligned_vector<T> _scratch;
+
+		public:
+		/** Create a new STFT engine.
+		 *
+		 * @argument channels Number of channels.
+		 * @argument frame Frame and FFT size in samples, must be a power of two and at least 4.
+		 * @argument hop Samples between the start of two frames, must evenly divide the frame size.
+		 * @argument shape Window applied to every frame.
+		 * @argument max_block Largest host block size, larger blocks are split up internally.
+		 */
+		stft(size_t channels, size_t frame, size_t hop, window shape = window::hann, size_t max_block = 4096);
+		~stft();
+
+		size_t frame() const;
+		size_t hop() const;
+
+		/** Number of bins in each spectrum, frame()/2 + 1.
+		 */
+		size_t bins() const;
+
+		/** Total latency in samples, report this to the host.
+		 */
+		size_t latency() const;
+
+		/** Drop all buffered audio and overlap.
+		 */
+		void reset();
+
+		/** Process a host block.
+		 *
+		 * @argument input Pointers to each input channel.
+		 * @argument output Pointers to each output channel, may be the same as input.
+		 * @argument samples Number of samples in the block.
+		 * @argument callback Callable as callback(T* const* re, T* const* im, size_t bins), with one aligned spectrum per
+		 *                    channel, called once per hop. Modify the spectra in place.
+		 */
+		template<typename Callback>
+		void process(T const* const* input, T* const* output, size_t samples, Callback&& callback)
+		{
+			_reframer.process(input, output, samples, [this, &callback](T const* const* source, T* const* target, size_t) {
+				analyze(source);
+				callback(_re_ptrs.data(), _im_ptrs.data(), _bins);
+				synthesize(target);
+			});
+		}
+
+		public:
+		/** Retrieve a shared analysis/synthesis window pair.
+		 */
+		static std::shared_ptr<window_pair const> get_window(window shape, size_t frame, size_t hop);
+
+		private:
+		void analyze(T const* const* input);
+		void synthesize(T* const* output);
+	};
+
+} // namespace tonplugins::dsp
@@ -0,0 +1,226 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#include "biquad.hpp"
+#include "simd.hpp"
+
+#include "warning-disable.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <stdexcept>
+#include "warning-enable.hpp"
+
+namespace {
+	struct rbj {
+		double cosw;
+		double alpha;
+		double a;
+
+		rbj(double sample_rate, double frequency, double q, double gain_db = 0.)
+		{
+			double w = 2. * std::numbers::pi * frequency / sample_rate;
+			cosw     = std::cos(w);
+			alpha    = std::sin(w) / (2. * q);
+			a        = std::pow(10., gain_db / 40.);
+		}
+	};
+
+	template<typename T>
+	tonplugins::dsp::biquad_coefficients<T> normalize(double b0, double b1, double b2, double a0, double a1, double a2)
+	{
+		tonplugins::dsp::biquad_coefficients<T> c;
+		c.b0 = static_cast<T>(b0 / a0);
+		c.b1 = static_cast<T>(b1 / a0);
+		c.b2 = static_cast<T>(b2 / a0);
+		c.a1 = static_cast<T>(a1 / a0);
+		c.a2 = static_cast<T>(a2 / a0);
+		return c;
+	}
+} // namespace
+
+template<typename T>
+tonplugins::dsp::biquad_coefficients<T> tonplugins::dsp::biquad_coefficients<T>::lowpass(double sample_rate, double frequency, double q)
+{
+	rbj p(sample_rate, frequency, q);
+	return normalize<T>((1. - p.cosw) / 2., 1. - p.cosw, (1. - p.cosw) / 2., 1. + p.alpha, -2. * p.cosw, 1. - p.alpha);
+}
+
+template<typename T>
+tonplugins::dsp::biquad_coefficients<T> tonplugins::dsp::biquad_coefficients<T>::highpass(double sample_rate, double frequency, double q)
+{
+	rbj p(sample_rate, frequency, q);
+	return normalize<T>((1. + p.cosw) / 2., -(1. + p.cosw), (1. + p.cosw) / 2., 1. + p.alpha, -2. * p.cosw, 1. - p.alpha);
+}
+
+template<typename T>
+tonplugins::dsp::biquad_coefficients<T> tonplugins::dsp::biquad_coefficients<T>::bandpass(double sample_rate, double frequency, double q)
+{
+	rbj p(sample_rate, frequency, q);
+	return normalize<T>(p.alpha, 0., -p.alpha, 1. + p.alpha, -2. * p.cosw, 1. - p.alpha);
+}
+
+template<typename T>
+tonplugins::dsp::biquad_coefficients<T> tonplugins::dsp::biquad_coefficients<T>::notch(double sample_rate, double frequency, double q)
+{
+	rbj p(sample_rate, frequency, q);
+	return normalize<T>(1., -2. * p.cosw, 1., 1. + p.alpha, -2. * p.cosw, 1. - p.alpha);
+}
+
+template<typename T>
+tonplugins::dsp::biquad_coefficients<T> tonplugins::dsp::biquad_coefficients<T>::allpass(double sample_rate, double frequency, double q)
+{
+	rbj p(sample_rate, frequency, q);
+	return normalize<T>(1. - p.alpha, -2. * p.cosw, 1. + p.alpha, 1. + p.alpha, -2. * p.cosw, 1. - p.alpha);
+}
+
+template<typename T>
+tonplugins::dsp::biquad_coefficients<T> tonplugins::dsp::biquad_coefficients<T>::peak(double sample_rate, double frequency, double q, double gain_db)
+{
+	rbj p(sample_rate, frequency, q, gain_db);
+	return normalize<T>(1. + p.alpha * p.a, -2. * p.cosw, 1. - p.alpha * p.a, 1. + p.alpha / p.a, -2. * p.cosw, 1. - p.alpha / p.a);
+}
+
+template<typename T>
+tonplugins::dsp::biquad_coefficients<T> tonplugins::dsp::biquad_coefficients<T>::lowshelf(double sample_rate, double frequency, double q, double gain_db)
+{
+	rbj    p(sample_rate, frequency, q, gain_db);
+	double s = 2. * std::sqrt(p.a) * p.alpha;
+	return normalize<T>(p.a * ((p.a + 1.) - (p.a - 1.) * p.cosw + s), 2. * p.a * ((p.a - 1.) - (p.a + 1.) * p.cosw), p.a * ((p.a + 1.) - (p.a - 1.) * p.cosw - s), (p.a + 1.) + (p.a - 1.) * p.cosw + s, -2. * ((p.a - 1.) + (p.a + 1.) * p.cosw), (p.a + 1.) + (p.a - 1.) * p.cosw - s);
+}
+
+template<typename T>
+tonplugins::dsp::biquad_coefficients<T> tonplugins::dsp::biquad_coefficients<T>::highshelf(double sample_rate, double frequency, double q, double gain_db)
+{
+	rbj    p(sample_rate, frequency, q, gain_db);
+	double s = 2. * std::sqrt(p.a) * p.alpha;
+	return normalize<T>(p.a * ((p.a + 1.) + (p.a - 1.) * p.cosw + s), -2. * p.a * ((p.a - 1.) + (p.a + 1.) * p.cosw), p.a * ((p.a + 1.) + (p.a - 1.) * p.cosw - s), (p.a + 1.) - (p.a - 1.) * p.cosw + s, 2. * ((p.a - 1.) - (p.a + 1.) * p.cosw), (p.a + 1.) - (p.a - 1.) * p.cosw - s);
+}
+
+template<typename T>
+tonplugins::dsp::biquad<T>::biquad(size_t channels, size_t stages) : _channels(channels), _stages(stages)
+{
+	if ((channels == 0) || (stages == 0)) {
+		throw std::invalid_argument("A biquad cascade needs at least one channel and one stage.");
+	}
+
+	_width  = tonplugins::simd::native_t<T>::width;
+	_groups = (_channels + _width - 1) / _width;
+
+	_coefficients.resize(_groups * _stages * 5 * _width, T(0));
+	_state.resize(_groups * _stages * 2 * _width, T(0));
+	_scratch.resize(chunk_size * _width, T(0));
+
+	// Start out as a pass-through filter.
+	for (size_t stage = 0; stage < _stages; stage++) {
+		set(stage, biquad_coefficients<T>{});
+	}
+}
+
+template<typename T>
+tonplugins::dsp::biquad<T>::~biquad() = default;
+
+template<typename T>
+size_t tonplugins::dsp::biquad<T>::channels() const
+{
+	return _channels;
+}
+
+template<typename T>
+size_t tonplugins::dsp::biquad<T>::stages() const
+{
+	return _stages;
+}
+
+template<typename T>
+void tonplugins::dsp::biquad<T>::set(size_t stage, size_t channel, biquad_coefficients<T> const& coefficients)
+{
+	if ((stage >= _stages) || (channel >= _channels)) {
+		throw std::out_of_range("Stage or channel out of range.");
+	}
+
+	size_t group = channel / _width;
+	size_t lane  = channel % _width;
+	T*     ptr   = _coefficients.data() + ((group * _stages + stage) * 5 * _width) + lane;
+
+	ptr[0 * _width] = coefficients.b0;
+	ptr[1 * _width] = coefficients.b1;
+	ptr[2 * _width] = coefficients.b2;
+	ptr[3 * _width] = coefficients.a1;
+	ptr[4 * _width] = coefficients.a2;
+}
+
+template<typename T>
+void tonplugins::dsp::biquad<T>::set(size_t stage, biquad_coefficients<T> const& coefficients)
+{
+	for (size_t channel = 0; channel < _channels; channel++) {
+		set(stage, channel, coefficients);
+	}
+}
+
+template<typename T>
+void tonplugins::dsp::biquad<T>::reset()
+{
+	std::fill(_state.begin(), _state.end(), T(0));
+}
+
+template<typename T>
+void tonplugins::dsp::biquad<T>::process(T* const* data, size_t samples)
+{
+	typedef tonplugins::simd::native_t<T> vec_t;
+
+	for (size_t group = 0; group < _groups; group++) {
+		size_t first = group * _width;
+		size_t lanes = std::min(_width, _channels - first);
+
+		for (size_t offset = 0; offset < samples; offset += chunk_size) {
+			size_t length = std::min(chunk_size, samples - offset);
+			T*     buffer = _scratch.data();
+
+			// Interleave the channels of this group into the lanes.
+			for (size_t lane = 0; lane < lanes; lane++) {
+				T const* src = data[first + lane] + offset;
+				for (size_t idx = 0; idx < length; idx++) {
+					buffer[idx * _width + lane] = src[idx];
+				}
+			}
+
+			for (size_t stage = 0; stage < _stages; stage++) {
+				T const* c  = _coefficients.data() + ((group * _stages + stage) * 5 * _width);
+				T*       s  = _state.data() + ((group * _stages + stage) * 2 * _width);
+				vec_t    b0 = vec_t::load(c + 0 * _width);
+				vec_t    b1 = vec_t::load(c + 1 * _width);
+				vec_t    b2 = vec_t::load(c + 2 * _width);
+				vec_t    a1 = vec_t::load(c + 3 * _width);
+				vec_t    a2 = vec_t::load(c + 4 * _width);
+				vec_t    s1 = vec_t::load(s);
+				vec_t    s2 = vec_t::load(s + _width);
+
+				for (size_t idx = 0; idx < length; idx++) {
+					vec_t x = vec_t::load(buffer + idx * _width);
+					vec_t y = tonplugins::simd::madd(b0, x, s1);
+					s1      = (tonplugins::simd::madd(b1, x, s2)) - (a1 * y);
+					s2      = (b2 * x) - (a2 * y);
+					y.store(buffer + idx * _width);
+				}
+
+				s1.store(s);
+				s2.store(s + _width);
+			}
+
+			// And back out into the channels.
+			for (size_t lane = 0; lane < lanes; lane++) {
+				T* dst = data[first + lane] + offset;
+				for (size_t idx = 0; idx < length; idx++) {
+					dst[idx] = buffer[idx * _width + lane];
+				}
+			}
+		}
+	}
+}
+
+template struct tonplugins::dsp::biquad_coefficients<float>;
+template struct tonplugins::dsp::biquad_coefficients<double>;
+template class tonplugins::dsp::biquad<float>;
+template class tonplugins::dsp::biquad<double>;
@@ -0,0 +1,251 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#include "convolver.hpp"
+#include "simd.hpp"
+
+#include "warning-disable.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include "warning-enable.hpp"
+
+static size_t next_power_of_two(size_t value)
+{
+	size_t result = 1;
+	while (result < value) {
+		result <<= 1;
+	}
+	return result;
+}
+
+template<typename T>
+tonplugins::dsp::uniform_convolver<T>::uniform_convolver(T const* ir, size_t length, size_t partition) : _partition(partition), _position(0)
+{
+	if ((partition < 2) || ((partition & (partition - 1)) != 0)) {
+		throw std::invalid_argument("Partition size must be a power of two.");
+	}
+
+	_fft        = tonplugins::dsp::fft<T>::get(_partition * 2);
+	_bins       = _fft->bins();
+	_partitions = std::max<size_t>(1, (length + _partition - 1) / _partition);
+
+	_ir_re.resize(_partitions * _bins, T(0));
+	_ir_im.resize(_partitions * _bins, T(0));
+	_fdl_re.resize(_partitions * _bins, T(0));
+	_fdl_im.resize(_partitions * _bins, T(0));
+	_input.resize(_partition * 2, T(0));
+	_output.resize(_partition * 2, T(0));
+	_acc_re.resize(_bins, T(0));
+	_acc_im.resize(_bins, T(0));
+
+	// Transform each partition of the impulse response, with the inverse transform's normalization folded in.
+	T scale = T(1) / static_cast<T>(_partition * 2);
+	for (size_t part = 0; part < _partitions; part++) {
+		std::fill(_input.begin(), _input.end(), T(0));
+		size_t offset = part * _partition;
+		size_t count  = std::min(_partition, (length > offset) ? (length - offset) : 0);
+		for (size_t idx = 0; idx < count; idx++) {
+			_input[idx] = ir[offset + idx] * scale;
+		}
+		_fft->forward(_input.data(), _ir_re.data() + part * _bins, _ir_im.data() + part * _bins);
+	}
+
+	reset();
+}
+
+template<typename T>
+tonplugins::dsp::uniform_convolver<T>::~uniform_convolver() = default;
+
+template<typename T>
+size_t tonplugins::dsp::uniform_convolver<T>::partition() const
+{
+	return _partition;
+}
+
+template<typename T>
+void tonplugins::dsp::uniform_convolver<T>::reset()
+{
+	std::fill(_fdl_re.begin(), _fdl_re.end(), T(0));
+	std::fill(_fdl_im.begin(), _fdl_im.end(), T(0));
+	std::fill(_input.begin(), _input.end(), T(0));
+	_position = 0;
+}
+
+template<typename T>
+void tonplugins::dsp::uniform_convolver<T>::process(T const* input, T* output)
+{
+	typedef tonplugins::simd::native_t<T> vec_t;
+
+	// Slide the input window by one partition, and transform it into the frequency-domain delay line.
+	memmove(_input.data(), _input.data() + _partition, _partition * sizeof(T));
+	memcpy(_input.data() + _partition, input, _partition * sizeof(T));
+	_fft->forward(_input.data(), _fdl_re.data() + _position * _bins, _fdl_im.data() + _position * _bins);
+
+	// Multiply-accumulate every delayed input spectrum with its impulse response partition.
+	std::fill(_acc_re.begin(), _acc_re.end(), T(0));
+	std::fill(_acc_im.begin(), _acc_im.end(), T(0));
+	size_t vector_bins = (_bins / vec_t::width) * vec_t::width;
+	for (size_t part = 0; part < _partitions; part++) {
+		size_t   slot = (_position + _partitions - part) % _partitions;
+		T const* xr   = _fdl_re.data() + slot * _bins;
+		T const* xi   = _fdl_im.data() + slot * _bins;
+		T const* hr   = _ir_re.data() + part * _bins;
+		T const* hi   = _ir_im.data() + part * _bins;
+		T*       ar   = _acc_re.data();
+		T*       ai   = _acc_im.data();
+
+		size_t bin = 0;
+		for (; bin < vector_bins; bin += vec_t::width) {
+			vec_t vxr = vec_t::load(xr + bin);
+			vec_t vxi = vec_t::load(xi + bin);
+			vec_t vhr = vec_t::load(hr + bin);
+			vec_t vhi = vec_t::load(hi + bin);
+			(vec_t::load(ar + bin) + ((vxr * vhr) - (vxi * vhi))).store(ar + bin);
+			(vec_t::load(ai + bin) + ((vxr * vhi) + (vxi * vhr))).store(ai + bin);
+		}
+		for (; bin < _bins; bin++) {
+			ar[bin] += xr[bin] * hr[bin] - xi[bin] * hi[bin];
+			ai[bin] += xr[bin] * hi[bin] + xi[bin] * hr[bin];
+		}
+	}
+
+	// Back to the time domain, only the second half is free of circular aliasing.
+	_fft->inverse(_acc_re.data(), _acc_im.data(), _output.data());
+	memcpy(output, _output.data() + _partition, _partition * sizeof(T));
+
+	_position = (_position + 1) % _partitions;
+}
+
+template<typename T>
+tonplugins::dsp::convolver<T>::convolver(T const* ir, size_t length, size_t block, size_t max_partition) : _fill(0), _cursor(0)
+{
+	_block        = next_power_of_two(std::max<size_t>(block, 2));
+	max_partition = std::max(_block, next_power_of_two(max_partition));
+
+	// Segment i with partition size P must start at an offset of at least P - block into the impulse response, as
+	// it needs P samples of input before it can produce any output. Four partitions per segment and a growth factor
+	// of four satisfy this for every segment.
+	constexpr size_t partitions_per_segment = 4;
+	constexpr size_t growth                 = 4;
+
+	size_t offset      = 0;
+	size_t partition   = _block;
+	size_t accumulator = _block;
+	do {
+		size_t next = std::min(partition * growth, max_partition);
+		size_t remaining = (length > offset) ? (length - offset) : 0;
+		size_t count     = remaining;
+		if (next != partition) {
+			count = std::min(remaining, partitions_per_segment * partition);
+		}
+
+		segment seg;
+		seg.engine = std::make_unique<uniform_convolver<T>>(ir + offset, count, partition);
+		seg.offset = offset;
+		seg.fill   = 0;
+		if (partition != _block) {
+			seg.input.resize(partition, T(0));
+			seg.output.resize(partition, T(0));
+		}
+		_segments.push_back(std::move(seg));
+
+		accumulator = std::max(accumulator, offset + _block);
+		offset += count;
+		partition = next;
+	} while (offset < length);
+
+	_input.resize(_block, T(0));
+	_output.resize(_block, T(0));
+	_accumulator.resize(next_power_of_two(accumulator), T(0));
+}
+
+template<typename T>
+tonplugins::dsp::convolver<T>::~convolver() = default;
+
+template<typename T>
+size_t tonplugins::dsp::convolver<T>::latency() const
+{
+	return _block;
+}
+
+template<typename T>
+size_t tonplugins::dsp::convolver<T>::block() const
+{
+	return _block;
+}
+
+template<typename T>
+void tonplugins::dsp::convolver<T>::reset()
+{
+	for (auto& seg : _segments) {
+		seg.engine->reset();
+		seg.fill = 0;
+	}
+	std::fill(_input.begin(), _input.end(), T(0));
+	std::fill(_output.begin(), _output.end(), T(0));
+	std::fill(_accumulator.begin(), _accumulator.end(), T(0));
+	_fill   = 0;
+	_cursor = 0;
+}
+
+template<typename T>
+void tonplugins::dsp::convolver<T>::process(T const* input, T* output, size_t samples)
+{
+	while (samples > 0) {
+		size_t length = std::min(samples, _block - _fill);
+		memcpy(_input.data() + _fill, input, length * sizeof(T));
+		memcpy(output, _output.data() + _fill, length * sizeof(T));
+
+		_fill += length;
+		input += length;
+		output += length;
+		samples -= length;
+
+		if (_fill == _block) {
+			process_block();
+			_fill = 0;
+		}
+	}
+}
+
+template<typename T>
+void tonplugins::dsp::convolver<T>::process_block()
+{
+	size_t mask = _accumulator.size() - 1;
+
+	// The head segment runs at the block size, and produces output for this exact block.
+	_segments[0].engine->process(_input.data(), _output.data());
+
+	// Tail segments collect input until a full partition is available, then add their output into the future.
+	for (size_t idx = 1; idx < _segments.size(); idx++) {
+		segment& seg       = _segments[idx];
+		size_t   partition = seg.engine->partition();
+
+		memcpy(seg.input.data() + seg.fill, _input.data(), _block * sizeof(T));
+		seg.fill += _block;
+		if (seg.fill < partition) {
+			continue;
+		}
+		seg.fill = 0;
+
+		seg.engine->process(seg.input.data(), seg.output.data());
+		size_t start = _cursor + seg.offset + _block - partition;
+		for (size_t sample = 0; sample < partition; sample++) {
+			_accumulator[(start + sample) & mask] += seg.output[sample];
+		}
+	}
+
+	for (size_t sample = 0; sample < _block; sample++) {
+		size_t pos = (_cursor + sample) & mask;
+		_output[sample] += _accumulator[pos];
+		_accumulator[pos] = T(0);
+	}
+	_cursor = (_cursor + _block) & mask;
+}
+
+template class tonplugins::dsp::uniform_convolver<float>;
+template class tonplugins::dsp::uniform_convolver<double>;
+template class tonplugins::dsp::convolver<float>;
+template class tonplugins::dsp::convolver<double>;
@@ -0,0 +1,218 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#include "fft.hpp"
+#include "core.hpp"
+#include "simd.hpp"
+
+#include "warning-disable.hpp"
+#include <cmath>
+#include <numbers>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include "warning-enable.hpp"
+
+template<typename T>
+tonplugins::dsp::fft<T>::fft(size_t size) : _size(size), _half(size / 2)
+{
+	if ((size < 4) || ((size & (size - 1)) != 0) || (size > (size_t(1) << 31))) {
+		throw std::invalid_argument("FFT size must be a power of two, and at least 4.");
+	}
+
+	// Bit reversal permutation for the half-size complex transform.
+	size_t bits = 0;
+	while ((size_t(1) << bits) < _half) {
+		bits++;
+	}
+	_bitreverse.resize(_half);
+	for (size_t idx = 0; idx < _half; idx++) {
+		size_t rev = 0;
+		for (size_t bit = 0; bit < bits; bit++) {
+			rev |= ((idx >> bit) & 1) << (bits - 1 - bit);
+		}
+		_bitreverse[idx] = static_cast<uint32_t>(rev);
+	}
+
+	// Twiddles for each butterfly stage, stored contiguously so they can be loaded as vectors.
+	// The stage with butterfly span 'h' finds its 'h' twiddles at offset 'h - 1'.
+	_stage_re.resize(std::max<size_t>(_half, 1));
+	_stage_im.resize(std::max<size_t>(_half, 1));
+	for (size_t span = 1; span < _half; span <<= 1) {
+		for (size_t idx = 0; idx < span; idx++) {
+			double angle                = -std::numbers::pi * static_cast<double>(idx) / static_cast<double>(span);
+			_stage_re[span - 1 + idx] = static_cast<T>(std::cos(angle));
+			_stage_im[span - 1 + idx] = static_cast<T>(std::sin(angle));
+		}
+	}
+
+	// Twiddles for splitting the half-size complex transform into the real transform.
+	_real_re.resize(_half / 2 + 1);
+	_real_im.resize(_half / 2 + 1);
+	for (size_t idx = 0; idx <= _half / 2; idx++) {
+		double angle  = -2. * std::numbers::pi * static_cast<double>(idx) / static_cast<double>(_size);
+		_real_re[idx] = static_cast<T>(std::cos(angle));
+		_real_im[idx] = static_cast<T>(std::sin(angle));
+	}
+}
+
+template<typename T>
+tonplugins::dsp::fft<T>::~fft() = default;
+
+template<typename T>
+size_t tonplugins::dsp::fft<T>::size() const
+{
+	return _size;
+}
+
+template<typename T>
+size_t tonplugins::dsp::fft<T>::bins() const
+{
+	return _half + 1;
+}
+
+template<typename T>
+void tonplugins::dsp::fft<T>::forward(T const* input, T* re, T* im) const
+{
+	// Pack even samples as real and odd samples as imaginary parts, already in bit-reversed order.
+	for (size_t idx = 0; idx < _half; idx++) {
+		re[_bitreverse[idx]] = input[idx * 2];
+		im[_bitreverse[idx]] = input[idx * 2 + 1];
+	}
+
+	transform(re, im);
+
+	// Split the result into the spectrum of the real signal.
+	T z0r     = re[0];
+	T z0i     = im[0];
+	re[0]     = z0r + z0i;
+	im[0]     = 0;
+	re[_half] = z0r - z0i;
+	im[_half] = 0;
+	for (size_t k = 1; k <= _half / 2; k++) {
+		size_t mk = _half - k;
+		T      ar = re[k], ai = im[k];
+		T      br = re[mk], bi = im[mk];
+
+		T er = (ar + br) * T(0.5);
+		T ei = (ai - bi) * T(0.5);
+		T or_ = (ai + bi) * T(0.5);
+		T oi  = (br - ar) * T(0.5);
+
+		T wr = _real_re[k], wi = _real_im[k];
+		T tr = wr * or_ - wi * oi;
+		T ti = wr * oi + wi * or_;
+
+		re[k]  = er + tr;
+		im[k]  = ei + ti;
+		re[mk] = er - tr;
+		im[mk] = ti - ei;
+	}
+}
+
+template<typename T>
+void tonplugins::dsp::fft<T>::inverse(T* re, T* im, T* output) const
+{
+	// Merge the real spectrum back into a half-size complex spectrum.
+	{
+		T x0r = re[0];
+		T xnr = re[_half];
+		re[0] = x0r + xnr;
+		im[0] = x0r - xnr;
+	}
+	for (size_t k = 1; k <= _half / 2; k++) {
+		size_t mk = _half - k;
+		T      ar = re[k], ai = im[k];
+		T      br = re[mk], bi = im[mk];
+
+		T er = ar + br;
+		T ei = ai - bi;
+		T dr = ar - br;
+		T di = ai + bi;
+
+		T wr  = _real_re[k], wi = _real_im[k];
+		T or_ = dr * wr + di * wi;
+		T oi  = di * wr - dr * wi;
+
+		re[k]  = er - oi;
+		im[k]  = ei + or_;
+		re[mk] = er + oi;
+		im[mk] = or_ - ei;
+	}
+
+	for (size_t idx = 0; idx < _half; idx++) {
+		size_t rev = _bitreverse[idx];
+		if (idx < rev) {
+			std::swap(re[idx], re[rev]);
+			std::swap(im[idx], im[rev]);
+		}
+	}
+
+	// Swapping real and imaginary parts turns the forward transform into the inverse transform.
+	transform(im, re);
+
+	for (size_t idx = 0; idx < _half; idx++) {
+		output[idx * 2]     = re[idx];
+		output[idx * 2 + 1] = im[idx];
+	}
+}
+
+template<typename T>
+void tonplugins::dsp::fft<T>::transform(T* re, T* im) const
+{
+	typedef tonplugins::simd::native_t<T> vec_t;
+
+	// Iterative radix-2 decimation in time, on bit-reversed input.
+	for (size_t span = 1; span < _half; span <<= 1) {
+		T const* tw_re = _stage_re.data() + (span - 1);
+		T const* tw_im = _stage_im.data() + (span - 1);
+
+		if (span >= vec_t::width) {
+			for (size_t base = 0; base < _half; base += span * 2) {
+				T* are = re + base;
+				T* aim = im + base;
+				T* bre = are + span;
+				T* bim = aim + span;
+				for (size_t idx = 0; idx < span; idx += vec_t::width) {
+					vec_t wr = vec_t::load(tw_re + idx);
+					vec_t wi = vec_t::load(tw_im + idx);
+					vec_t xr = vec_t::load(bre + idx);
+					vec_t xi = vec_t::load(bim + idx);
+					vec_t tr = (xr * wr) - (xi * wi);
+					vec_t ti = (xr * wi) + (xi * wr);
+					vec_t yr = vec_t::load(are + idx);
+					vec_t yi = vec_t::load(aim + idx);
+					(yr - tr).store(bre + idx);
+					(yi - ti).store(bim + idx);
+					(yr + tr).store(are + idx);
+					(yi + ti).store(aim + idx);
+				}
+			}
+		} else {
+			for (size_t base = 0; base < _half; base += span * 2) {
+				for (size_t idx = 0; idx < span; idx++) {
+					size_t a  = base + idx;
+					size_t b  = a + span;
+					T      tr = re[b] * tw_re[idx] - im[b] * tw_im[idx];
+					T      ti = re[b] * tw_im[idx] + im[b] * tw_re[idx];
+					re[b]     = re[a] - tr;
+					im[b]     = im[a] - ti;
+					re[a] += tr;
+					im[a] += ti;
+				}
+			}
+		}
+	}
+}
+
+template<typename T>
+std::shared_ptr<tonplugins::dsp::fft<T>> tonplugins::dsp::fft<T>::get(size_t size)
+{
+	std::string key = std::string(std::is_same_v<T, float> ? "tonplugins::dsp::fft<float>/" : "tonplugins::dsp::fft<double>/") + std::to_string(size);
+	return tonplugins::core::instance()->cached<fft<T>>(key, [size]() { return std::make_shared<fft<T>>(size); });
+}
+
+template class tonplugins::dsp::fft<float>;
+template class tonplugins::dsp::fft<double>;
@@ -0,0 +1,102 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#include "fir.hpp"
+#include "simd.hpp"
+
+#include "warning-disable.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include "warning-enable.hpp"
+
+template<typename T>
+tonplugins::dsp::fir<T>::fir(size_t channels, T const* kernel, size_t taps) : _channels(channels), _taps(taps)
+{
+	if ((channels == 0) || (taps == 0) || (kernel == nullptr)) {
+		throw std::invalid_argument("A FIR filter needs at least one channel and one tap.");
+	}
+
+	_kernel.resize(padded_taps(), T(0));
+	_history.resize(_channels);
+	for (auto& history : _history) {
+		history.resize(padded_taps() - 1 + chunk_size, T(0));
+	}
+
+	set(kernel);
+}
+
+template<typename T>
+tonplugins::dsp::fir<T>::~fir() = default;
+
+template<typename T>
+size_t tonplugins::dsp::fir<T>::channels() const
+{
+	return _channels;
+}
+
+template<typename T>
+size_t tonplugins::dsp::fir<T>::taps() const
+{
+	return _taps;
+}
+
+template<typename T>
+void tonplugins::dsp::fir<T>::set(T const* kernel)
+{
+	// Reverse the kernel, so that each output is a plain dot product with the most recent input.
+	size_t padded = padded_taps();
+	std::fill(_kernel.begin(), _kernel.end(), T(0));
+	for (size_t idx = 0; idx < _taps; idx++) {
+		_kernel[padded - 1 - idx] = kernel[idx];
+	}
+}
+
+template<typename T>
+void tonplugins::dsp::fir<T>::reset()
+{
+	for (auto& history : _history) {
+		std::fill(history.begin(), history.end(), T(0));
+	}
+}
+
+template<typename T>
+void tonplugins::dsp::fir<T>::process(T* const* data, size_t samples)
+{
+	typedef tonplugins::simd::native_t<T> vec_t;
+
+	size_t   padded = padded_taps();
+	T const* kernel = _kernel.data();
+
+	for (size_t channel = 0; channel < _channels; channel++) {
+		T* history = _history[channel].data();
+		T* io      = data[channel];
+
+		for (size_t offset = 0; offset < samples; offset += chunk_size) {
+			size_t length = std::min(chunk_size, samples - offset);
+			memcpy(history + (padded - 1), io + offset, length * sizeof(T));
+
+			for (size_t idx = 0; idx < length; idx++) {
+				T const* window = history + idx;
+				vec_t    acc    = vec_t::zero();
+				for (size_t tap = 0; tap < padded; tap += vec_t::width) {
+					acc = tonplugins::simd::madd(vec_t::load(window + tap), vec_t::load(kernel + tap), acc);
+				}
+				io[offset + idx] = tonplugins::simd::hsum(acc);
+			}
+
+			memmove(history, history + length, (padded - 1) * sizeof(T));
+		}
+	}
+}
+
+template<typename T>
+size_t tonplugins::dsp::fir<T>::padded_taps() const
+{
+	size_t width = tonplugins::simd::native_t<T>::width;
+	return ((_taps + width - 1) / width) * width;
+}
+
+template class tonplugins::dsp::fir<float>;
+template class tonplugins::dsp::fir<double>;
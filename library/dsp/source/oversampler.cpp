@@ -0,0 +1,332 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#include "oversampler.hpp"
+#include "core.hpp"
+#include "fft.hpp"
+#include "simd.hpp"
+
+#include "warning-disable.hpp"
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <numbers>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include "warning-enable.hpp"
+
+static double bessel_i0(double x)
+{
+	double sum  = 1.;
+	double term = 1.;
+	for (size_t k = 1; k < 64; k++) {
+		term *= (x / (2. * static_cast<double>(k))) * (x / (2. * static_cast<double>(k)));
+		sum += term;
+		if (term < (sum * 1e-17)) {
+			break;
+		}
+	}
+	return sum;
+}
+
+/** Turn a filter into its minimum-phase counterpart with the same magnitude response, using the real cepstrum.
+ */
+static std::vector<double> minimum_phase(std::vector<double> const& kernel)
+{
+	// Plenty of padding, or the cepstrum aliases.
+	size_t size = std::bit_ceil(std::max<size_t>(kernel.size() * 32, 1024));
+	double norm = 1. / static_cast<double>(size);
+
+	// Designing several stages and modes tends to need the same size over and over.
+	auto                plan = tonplugins::dsp::fft<double>::get(size);
+	std::vector<double> buffer(size, 0.);
+	std::vector<double> re(plan->bins());
+	std::vector<double> im(plan->bins());
+
+	// Log magnitude, floored to keep the zeros in the stop band finite.
+	std::copy(kernel.begin(), kernel.end(), buffer.begin());
+	plan->forward(buffer.data(), re.data(), im.data());
+	for (size_t bin = 0; bin < plan->bins(); bin++) {
+		re[bin] = std::log(std::max(std::hypot(re[bin], im[bin]), 1e-12));
+		im[bin] = 0.;
+	}
+	plan->inverse(re.data(), im.data(), buffer.data());
+
+	// Fold the anti-causal half of the cepstrum onto the causal half.
+	buffer[0] *= norm;
+	for (size_t idx = 1; idx < size / 2; idx++) {
+		buffer[idx] *= 2. * norm;
+	}
+	buffer[size / 2] *= norm;
+	std::fill(buffer.begin() + static_cast<ptrdiff_t>(size / 2 + 1), buffer.end(), 0.);
+
+	plan->forward(buffer.data(), re.data(), im.data());
+	for (size_t bin = 0; bin < plan->bins(); bin++) {
+		double magnitude = std::exp(re[bin]);
+		double phase     = im[bin];
+		re[bin]          = magnitude * std::cos(phase);
+		im[bin]          = magnitude * std::sin(phase);
+	}
+	plan->inverse(re.data(), im.data(), buffer.data());
+
+	std::vector<double> result(kernel.size());
+	for (size_t idx = 0; idx < result.size(); idx++) {
+		result[idx] = buffer[idx] * norm;
+	}
+	return result;
+}
+
+template<typename T>
+tonplugins::dsp::oversampler<T>::oversampler(size_t channels, size_t factor, quality level, mode response, size_t max_block) : _channels(channels), _factor(factor), _max_block(max_block)
+{
+	if ((channels == 0) || (max_block == 0)) {
+		throw std::invalid_argument("An oversampler needs at least one channel and a non-zero block size.");
+	}
+	if ((factor < 2) || (factor > 16) || !std::has_single_bit(factor)) {
+		throw std::invalid_argument("Oversampling factor must be 2, 4, 8 or 16.");
+	}
+	_stages = static_cast<size_t>(std::countr_zero(factor));
+
+	// Sum up the delay of every stage in samples at the highest rate, where both directions run at the stage's rate.
+	double delay = 0.;
+	for (size_t stage = 0; stage < _stages; stage++) {
+		_filters.push_back(design(stage, level, response));
+		delay += 2. * _filters[stage]->delay * static_cast<double>(_factor >> (stage + 1));
+	}
+	_latency = static_cast<size_t>(std::ceil((delay / static_cast<double>(_factor)) - 1e-6));
+	_padding = static_cast<size_t>(std::max(0., std::round(static_cast<double>(_latency * _factor) - delay)));
+
+	// Every buffer of every stage and channel from one arena, in the order they are used.
+	for (size_t stage = 0; stage < _stages; stage++) {
+		size_t taps  = _filters[stage]->taps;
+		size_t input = _max_block << stage;
+		for (size_t channel = 0; channel < _channels; channel++) {
+			_up.push_back(_arena.allocate<T>(taps - 1 + input));
+			_buffers.push_back(_arena.allocate<T>(input * 2));
+		}
+	}
+	for (size_t channel = 0; channel < _channels; channel++) {
+		_delay.push_back(_arena.allocate<T>(_padding + _max_block * _factor));
+	}
+	for (size_t stage = 0; stage < _stages; stage++) {
+		size_t taps   = _filters[stage]->taps;
+		size_t output = _max_block << stage;
+		for (size_t channel = 0; channel < _channels; channel++) {
+			_even.push_back(_arena.allocate<T>(taps - 1 + output));
+			_odd.push_back(_arena.allocate<T>(taps + output));
+		}
+	}
+	_targets.resize(_channels, nullptr);
+}
+
+template<typename T>
+tonplugins::dsp::oversampler<T>::~oversampler() = default;
+
+template<typename T>
+size_t tonplugins::dsp::oversampler<T>::channels() const
+{
+	return _channels;
+}
+
+template<typename T>
+size_t tonplugins::dsp::oversampler<T>::factor() const
+{
+	return _factor;
+}
+
+template<typename T>
+size_t tonplugins::dsp::oversampler<T>::latency() const
+{
+	return _latency;
+}
+
+template<typename T>
+void tonplugins::dsp::oversampler<T>::reset()
+{
+	_arena.zero();
+}
+
+template<typename T>
+T* const* tonplugins::dsp::oversampler<T>::upsample(T const* const* input, size_t samples)
+{
+	typedef tonplugins::simd::native_t<T> vec_t;
+
+	for (size_t stage = 0; stage < _stages; stage++) {
+		halfband const& filter = *_filters[stage];
+		size_t const    taps   = filter.taps;
+		size_t const    length = samples << stage;
+		T const*        even   = filter.coefficients.data();
+		T const*        odd    = even + taps;
+
+		for (size_t channel = 0; channel < _channels; channel++) {
+			T const* source  = (stage == 0) ? input[channel] : _buffers[(stage - 1) * _channels + channel];
+			T*       history = _up[stage * _channels + channel];
+			T*       target  = _buffers[stage * _channels + channel];
+			memcpy(history + (taps - 1), source, length * sizeof(T));
+
+			// Each input sample produces one output sample per phase, the gain of 2 makes up for the inserted zeros.
+			for (size_t idx = 0; idx < length; idx++) {
+				T const* window = history + idx;
+				vec_t    acc    = vec_t::zero();
+				for (size_t tap = 0; tap < taps; tap += vec_t::width) {
+					acc = tonplugins::simd::madd(vec_t::load(window + tap), vec_t::load(even + tap), acc);
+				}
+				target[idx * 2] = T(2) * tonplugins::simd::hsum(acc);
+
+				if (filter.sparse) {
+					target[idx * 2 + 1] = window[taps - 1 - filter.center];
+				} else {
+					acc = vec_t::zero();
+					for (size_t tap = 0; tap < taps; tap += vec_t::width) {
+						acc = tonplugins::simd::madd(vec_t::load(window + tap), vec_t::load(odd + tap), acc);
+					}
+					target[idx * 2 + 1] = T(2) * tonplugins::simd::hsum(acc);
+				}
+			}
+
+			memmove(history, history + length, (taps - 1) * sizeof(T));
+		}
+	}
+
+	return _buffers.data() + (_stages - 1) * _channels;
+}
+
+template<typename T>
+void tonplugins::dsp::oversampler<T>::downsample(T* const* output, size_t samples)
+{
+	typedef tonplugins::simd::native_t<T> vec_t;
+
+	if (_padding > 0) {
+		size_t length = samples * _factor;
+		for (size_t channel = 0; channel < _channels; channel++) {
+			T* top   = _buffers[(_stages - 1) * _channels + channel];
+			T* delay = _delay[channel];
+			memcpy(delay + _padding, top, length * sizeof(T));
+			memcpy(top, delay, length * sizeof(T));
+			memmove(delay, delay + length, _padding * sizeof(T));
+		}
+	}
+
+	for (size_t stage = _stages; stage-- > 0;) {
+		halfband const& filter = *_filters[stage];
+		size_t const    taps   = filter.taps;
+		size_t const    length = samples << stage;
+		T const*        even   = filter.coefficients.data();
+		T const*        odd    = even + taps;
+
+		for (size_t channel = 0; channel < _channels; channel++) {
+			T const* source     = _buffers[stage * _channels + channel];
+			T*       target     = (stage == 0) ? output[channel] : _buffers[(stage - 1) * _channels + channel];
+			T*       even_input = _even[stage * _channels + channel];
+			T*       odd_input  = _odd[stage * _channels + channel];
+
+			// Split into the two polyphase components, the odd one lags by one sample at the lower rate.
+			for (size_t idx = 0; idx < length; idx++) {
+				even_input[taps - 1 + idx] = source[idx * 2];
+				odd_input[taps + idx]      = source[idx * 2 + 1];
+			}
+
+			for (size_t idx = 0; idx < length; idx++) {
+				T const* even_window = even_input + idx;
+				T const* odd_window  = odd_input + idx;
+				vec_t    acc         = vec_t::zero();
+				for (size_t tap = 0; tap < taps; tap += vec_t::width) {
+					acc = tonplugins::simd::madd(vec_t::load(even_window + tap), vec_t::load(even + tap), acc);
+				}
+				if (filter.sparse) {
+					target[idx] = tonplugins::simd::hsum(acc) + T(.5) * odd_window[taps - 1 - filter.center];
+				} else {
+					for (size_t tap = 0; tap < taps; tap += vec_t::width) {
+						acc = tonplugins::simd::madd(vec_t::load(odd_window + tap), vec_t::load(odd + tap), acc);
+					}
+					target[idx] = tonplugins::simd::hsum(acc);
+				}
+			}
+
+			memmove(even_input, even_input + length, (taps - 1) * sizeof(T));
+			memmove(odd_input, odd_input + length, taps * sizeof(T));
+		}
+	}
+}
+
+template<typename T>
+std::shared_ptr<typename tonplugins::dsp::oversampler<T>::halfband const> tonplugins::dsp::oversampler<T>::design(size_t stage, quality level, mode response)
+{
+	std::string key = std::string(std::is_same_v<T, float> ? "tonplugins::dsp::oversampler<float>/" : "tonplugins::dsp::oversampler<double>/") + std::to_string(stage) + "/" + std::to_string(static_cast<int>(level)) + "/" + std::to_string(static_cast<int>(response));
+
+	return tonplugins::core::instance()->cached<halfband>(key, [stage, level, response]() {
+		auto filter = std::make_shared<halfband>();
+
+		double bandwidth   = .44;
+		double attenuation = 90.;
+		switch (level) {
+		case quality::low:
+			bandwidth = .40, attenuation = 60.;
+			break;
+		case quality::medium:
+			bandwidth = .44, attenuation = 90.;
+			break;
+		case quality::high:
+			bandwidth = .46, attenuation = 120.;
+			break;
+		}
+
+		// The audio band shrinks relative to each further stage's rate, which widens its transition band.
+		double pass       = bandwidth / static_cast<double>(size_t(2) << stage);
+		double transition = .5 - 2. * pass;
+
+		// Kaiser estimate for the length, as 4k+3 taps so the center lands on an odd index.
+		double estimate = (attenuation - 7.95) / (14.36 * transition);
+		size_t order    = std::max<size_t>(static_cast<size_t>(std::ceil(estimate / 2.)), 3) | 1;
+		size_t length   = order * 2 + 1;
+		double beta     = 0.1102 * (attenuation - 8.7);
+
+		// Windowed sinc with its cutoff at a quarter of the rate, every other tap besides the center is zero.
+		std::vector<double> kernel(length);
+		double              center = static_cast<double>(order);
+		for (size_t idx = 0; idx < length; idx++) {
+			double x      = static_cast<double>(idx) - center;
+			double sinc   = (x == 0.) ? 1. : std::sin(std::numbers::pi * x / 2.) / (std::numbers::pi * x / 2.);
+			double ratio  = x / (center + 1.);
+			double window = bessel_i0(beta * std::sqrt(std::max(0., 1. - ratio * ratio))) / bessel_i0(beta);
+			kernel[idx]   = .5 * sinc * window;
+		}
+		if (response == mode::minimum_phase) {
+			kernel = minimum_phase(kernel);
+		}
+
+		// Each phase must have a gain of exactly 0.5 at DC, or DC leaks into the image at the higher rate.
+		double sums[2] = {0., 0.};
+		for (size_t idx = 0; idx < length; idx++) {
+			sums[idx % 2] += kernel[idx];
+		}
+		for (size_t idx = 0; idx < length; idx++) {
+			kernel[idx] *= .5 / sums[idx % 2];
+		}
+
+		size_t width   = tonplugins::simd::native_t<T>::width;
+		size_t taps    = ((order + 1) + width - 1) / width * width;
+		filter->taps   = taps;
+		filter->sparse = (response == mode::linear_phase);
+		filter->center = (order - 1) / 2;
+
+		double moment = 0.;
+		for (size_t idx = 0; idx < length; idx++) {
+			moment += static_cast<double>(idx) * kernel[idx];
+		}
+		filter->delay = (response == mode::linear_phase) ? center : moment;
+
+		// Split into phases, reversed for dot products.
+		filter->coefficients.resize(taps * 2, T(0));
+		for (size_t idx = 0; idx < length; idx++) {
+			filter->coefficients[(idx % 2) * taps + (taps - 1 - idx / 2)] = static_cast<T>(kernel[idx]);
+		}
+
+		return filter;
+	});
+}
+
+template class tonplugins::dsp::oversampler<float>;
+template class tonplugins::dsp::oversampler<double>;
@@ -0,0 +1,255 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#include "resampler.hpp"
+#include "core.hpp"
+#include "simd.hpp"
+
+#include "warning-disable.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numbers>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include "warning-enable.hpp"
+
+// Keep filter banks to a sensible size, ratios like 44100:47999 would otherwise need tens of thousands of phases.
+constexpr size_t max_interpolation = 1024;
+
+static double bessel_i0(double x)
+{
+	double sum  = 1.;
+	double term = 1.;
+	for (size_t k = 1; k < 64; k++) {
+		term *= (x / (2. * static_cast<double>(k))) * (x / (2. * static_cast<double>(k)));
+		sum += term;
+		if (term < (sum * 1e-17)) {
+			break;
+		}
+	}
+	return sum;
+}
+
+template<typename T>
+tonplugins::dsp::resampler<T>::resampler(size_t channels, uint32_t input_rate, uint32_t output_rate, quality level) : _channels(channels), _phase(0)
+{
+	if ((channels == 0) || (input_rate == 0) || (output_rate == 0)) {
+		throw std::invalid_argument("A resampler needs at least one channel and non-zero sample rates.");
+	}
+
+	size_t divisor       = std::gcd(input_rate, output_rate);
+	size_t interpolation = output_rate / divisor;
+	size_t decimation    = input_rate / divisor;
+	if (interpolation > max_interpolation) {
+		throw std::invalid_argument("Sample rate ratio is too complex.");
+	}
+
+	_bank = design(interpolation, decimation, level);
+
+	_history.resize(_channels);
+	for (auto& history : _history) {
+		history.resize(_bank->taps - 1 + chunk_size, T(0));
+	}
+	_sources.resize(_channels, nullptr);
+	_targets.resize(_channels, nullptr);
+}
+
+template<typename T>
+tonplugins::dsp::resampler<T>::~resampler() = default;
+
+template<typename T>
+size_t tonplugins::dsp::resampler<T>::channels() const
+{
+	return _channels;
+}
+
+template<typename T>
+size_t tonplugins::dsp::resampler<T>::interpolation() const
+{
+	return _bank->interpolation;
+}
+
+template<typename T>
+size_t tonplugins::dsp::resampler<T>::decimation() const
+{
+	return _bank->decimation;
+}
+
+template<typename T>
+double tonplugins::dsp::resampler<T>::latency() const
+{
+	return _bank->delay * static_cast<double>(_bank->interpolation) / static_cast<double>(_bank->decimation);
+}
+
+template<typename T>
+double tonplugins::dsp::resampler<T>::input_latency() const
+{
+	return _bank->delay;
+}
+
+template<typename T>
+size_t tonplugins::dsp::resampler<T>::maximum_output(size_t input) const
+{
+	return (input * _bank->interpolation) / _bank->decimation + 1;
+}
+
+template<typename T>
+void tonplugins::dsp::resampler<T>::reset()
+{
+	for (auto& history : _history) {
+		std::fill(history.begin(), history.end(), T(0));
+	}
+	_phase = 0;
+}
+
+template<typename T>
+size_t tonplugins::dsp::resampler<T>::process(T const* const* input, size_t samples, T* const* output)
+{
+	typedef tonplugins::simd::native_t<T> vec_t;
+
+	size_t const interpolation = _bank->interpolation;
+	size_t const decimation    = _bank->decimation;
+	size_t const taps          = _bank->taps;
+	T const*     coefficients  = _bank->coefficients.data();
+
+	size_t produced = 0;
+	for (size_t offset = 0; offset < samples; offset += chunk_size) {
+		size_t length = std::min(chunk_size, samples - offset);
+		for (size_t channel = 0; channel < _channels; channel++) {
+			memcpy(_history[channel].data() + (taps - 1), input[channel] + offset, length * sizeof(T));
+		}
+
+		// Every output lands on an exact phase of the filter bank, no interpolation between phases is needed.
+		size_t count = 0;
+		size_t time  = _phase;
+		for (; (time / interpolation) < length; time += decimation, count++) {
+			size_t   index = time / interpolation;
+			T const* phase = coefficients + (time % interpolation) * taps;
+			for (size_t channel = 0; channel < _channels; channel++) {
+				T const* window = _history[channel].data() + index;
+				vec_t    acc    = vec_t::zero();
+				for (size_t tap = 0; tap < taps; tap += vec_t::width) {
+					acc = tonplugins::simd::madd(vec_t::load(window + tap), vec_t::load(phase + tap), acc);
+				}
+				output[channel][produced + count] = tonplugins::simd::hsum(acc);
+			}
+		}
+		_phase = time - length * interpolation;
+		produced += count;
+
+		for (size_t channel = 0; channel < _channels; channel++) {
+			T* history = _history[channel].data();
+			memmove(history, history + length, (taps - 1) * sizeof(T));
+		}
+	}
+
+	return produced;
+}
+
+template<typename T>
+size_t tonplugins::dsp::resampler<T>::process(tonplugins::memory::ring<T>* const* input, tonplugins::memory::ring<T>* const* output)
+{
+	// Figure out how much can be converted in one go.
+	size_t available = std::numeric_limits<size_t>::max();
+	size_t space     = std::numeric_limits<size_t>::max();
+	for (size_t channel = 0; channel < _channels; channel++) {
+		available = std::min(available, input[channel]->used());
+		space     = std::min(space, output[channel]->free());
+	}
+	if (space == 0) {
+		return 0;
+	}
+	available = std::min(available, ((space - 1) * _bank->decimation) / _bank->interpolation);
+	if (available == 0) {
+		return 0;
+	}
+
+	// Work directly on the mirrored memory of the rings.
+	for (size_t channel = 0; channel < _channels; channel++) {
+		_sources[channel] = input[channel]->peek(available);
+		_targets[channel] = output[channel]->poke(maximum_output(available));
+	}
+
+	size_t produced = process(_sources.data(), available, _targets.data());
+
+	for (size_t channel = 0; channel < _channels; channel++) {
+		input[channel]->read(available, nullptr);
+		output[channel]->write(produced, nullptr);
+	}
+
+	return produced;
+}
+
+template<typename T>
+std::shared_ptr<typename tonplugins::dsp::resampler<T>::filter_bank const> tonplugins::dsp::resampler<T>::design(size_t interpolation, size_t decimation, quality level)
+{
+	std::string key = std::string(std::is_same_v<T, float> ? "tonplugins::dsp::resampler<float>/" : "tonplugins::dsp::resampler<double>/") + std::to_string(interpolation) + "/" + std::to_string(decimation) + "/" + std::to_string(static_cast<int>(level));
+
+	return tonplugins::core::instance()->cached<filter_bank>(key, [interpolation, decimation, level]() {
+		auto bank           = std::make_shared<filter_bank>();
+		bank->interpolation = interpolation;
+		bank->decimation    = decimation;
+
+		size_t taps    = 32;
+		double beta    = 8.;
+		double rolloff = .9;
+		switch (level) {
+		case quality::low:
+			taps = 16, beta = 6., rolloff = .85;
+			break;
+		case quality::medium:
+			taps = 32, beta = 8., rolloff = .9;
+			break;
+		case quality::high:
+			taps = 64, beta = 10., rolloff = .94;
+			break;
+		}
+
+		// Downsampling needs a proportionally longer filter for the same transition width.
+		if (decimation > interpolation) {
+			taps = (taps * decimation + interpolation - 1) / interpolation;
+		}
+		size_t width  = tonplugins::simd::native_t<T>::width;
+		size_t padded = ((taps + width - 1) / width) * width;
+		bank->taps    = padded;
+
+		// Windowed sinc prototype at L times the input rate.
+		size_t length = taps * interpolation;
+		double center = static_cast<double>(length - 1) / 2.;
+		double cutoff = .5 * rolloff * std::min(1., static_cast<double>(interpolation) / static_cast<double>(decimation));
+		bank->delay   = center / static_cast<double>(interpolation);
+
+		std::vector<double> prototype(length);
+		for (size_t idx = 0; idx < length; idx++) {
+			double x      = (static_cast<double>(idx) - center) / static_cast<double>(interpolation);
+			double arg    = 2. * cutoff * x;
+			double sinc   = (std::abs(arg) < 1e-12) ? 1. : std::sin(std::numbers::pi * arg) / (std::numbers::pi * arg);
+			double ratio  = (static_cast<double>(idx) - center) / (center + 1.);
+			double window = bessel_i0(beta * std::sqrt(std::max(0., 1. - ratio * ratio))) / bessel_i0(beta);
+			prototype[idx] = sinc * window;
+		}
+
+		// Split into phases, reversed for dot products and normalized to unity gain at DC.
+		bank->coefficients.resize(interpolation * padded, T(0));
+		for (size_t phase = 0; phase < interpolation; phase++) {
+			double sum = 0.;
+			for (size_t tap = 0; tap < taps; tap++) {
+				sum += prototype[phase + tap * interpolation];
+			}
+			T* out = bank->coefficients.data() + phase * padded;
+			for (size_t tap = 0; tap < taps; tap++) {
+				out[padded - 1 - tap] = static_cast<T>(prototype[phase + tap * interpolation] / sum);
+			}
+		}
+
+		return bank;
+	});
+}
+
+template class tonplugins::dsp::resampler<float>;
+template class tonplugins::dsp::resampler<double>;
@@ -0,0 +1,182 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#include "stft.hpp"
+#include "core.hpp"
+#include "simd.hpp"
+
+#include "warning-disable.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numbers>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include "warning-enable.hpp"
+
+template<typename T>
+tonplugins::dsp::stft<T>::stft(size_t channels, size_t frame, size_t hop, window shape, size_t max_block) : _channels(channels), _frame(frame), _hop(hop), _bins(frame / 2 + 1), _fft(tonplugins::dsp::fft<T>::get(frame)), _window(get_window(shape, frame, hop)), _reframer(channels, hop, max_block, frame - hop)
+{
+	// The frame size was checked by the FFT plan and the hop size by get_window(), both before the reframer is created.
+
+	// Keep every channel's spectrum on its own cache line boundary.
+	size_t align = tonplugins::memory::default_alignment / sizeof(T);
+	_stride      = ((_bins + align - 1) / align) * align;
+	_re.resize(_channels * _stride, T(0));
+	_im.resize(_channels * _stride, T(0));
+	for (size_t channel = 0; channel < _channels; channel++) {
+		_re_ptrs.push_back(_re.data() + channel * _stride);
+		_im_ptrs.push_back(_im.data() + channel * _stride);
+	}
+
+	// The history never holds more than a frame, so a frame plus a hop never fills a ring.
+	for (size_t channel = 0; channel < _channels; channel++) {
+		_history.emplace_back(std::make_unique<tonplugins::memory::ring<T>>(_frame + _hop));
+	}
+	_overlap.resize(_channels * _frame, T(0));
+	_scratch.resize(_frame, T(0));
+
+	reset();
+}
+
+template<typename T>
+tonplugins::dsp::stft<T>::~stft() = default;
+
+template<typename T>
+size_t tonplugins::dsp::stft<T>::frame() const
+{
+	return _frame;
+}
+
+template<typename T>
+size_t tonplugins::dsp::stft<T>::hop() const
+{
+	return _hop;
+}
+
+template<typename T>
+size_t tonplugins::dsp::stft<T>::bins() const
+{
+	return _bins;
+}
+
+template<typename T>
+size_t tonplugins::dsp::stft<T>::latency() const
+{
+	return _reframer.latency();
+}
+
+template<typename T>
+void tonplugins::dsp::stft<T>::reset()
+{
+	_reframer.reset();
+	std::fill(_overlap.begin(), _overlap.end(), T(0));
+
+	// Prime the history, so that the very first hop already completes a frame.
+	for (auto& history : _history) {
+		history->read(history->used(), nullptr);
+		if (_frame > _hop) {
+			T* ptr = history->poke(_frame - _hop);
+			memset(ptr, 0, sizeof(T) * (_frame - _hop));
+			history->write(_frame - _hop, nullptr);
+		}
+	}
+}
+
+template<typename T>
+void tonplugins::dsp::stft<T>::analyze(T const* const* input)
+{
+	typedef tonplugins::simd::native_t<T> vec_t;
+
+	T const* window = _window->analysis.data();
+	for (size_t channel = 0; channel < _channels; channel++) {
+		auto& history = _history[channel];
+		history->write(_hop, input[channel]);
+
+		// The mirrored memory makes the whole frame contiguous, wherever it starts.
+		T const* frame = history->peek(_frame);
+		for (size_t idx = 0; idx < _frame; idx += vec_t::width) {
+			(vec_t::load(frame + idx) * vec_t::load(window + idx)).store(_scratch.data() + idx);
+		}
+		_fft->forward(_scratch.data(), _re_ptrs[channel], _im_ptrs[channel]);
+
+		history->read(_hop, nullptr);
+	}
+}
+
+template<typename T>
+void tonplugins::dsp::stft<T>::synthesize(T* const* output)
+{
+	typedef tonplugins::simd::native_t<T> vec_t;
+
+	T const* window = _window->synthesis.data();
+	for (size_t channel = 0; channel < _channels; channel++) {
+		_fft->inverse(_re_ptrs[channel], _im_ptrs[channel], _scratch.data());
+
+		T* overlap = _overlap.data() + channel * _frame;
+		for (size_t idx = 0; idx < _frame; idx += vec_t::width) {
+			tonplugins::simd::madd(vec_t::load(_scratch.data() + idx), vec_t::load(window + idx), vec_t::load(overlap + idx)).store(overlap + idx);
+		}
+
+		// The oldest hop has received all of its contributions.
+		memcpy(output[channel], overlap, sizeof(T) * _hop);
+		memmove(overlap, overlap + _hop, sizeof(T) * (_frame - _hop));
+		memset(overlap + (_frame - _hop), 0, sizeof(T) * _hop);
+	}
+}
+
+template<typename T>
+std::shared_ptr<typename tonplugins::dsp::stft<T>::window_pair const> tonplugins::dsp::stft<T>::get_window(window shape, size_t frame, size_t hop)
+{
+	if ((hop == 0) || (frame < hop) || ((frame % hop) != 0)) {
+		throw std::invalid_argument("Hop size must evenly divide the frame size.");
+	}
+
+	std::string key = std::string(std::is_same_v<T, float> ? "tonplugins::dsp::stft<float>/" : "tonplugins::dsp::stft<double>/") + std::to_string(static_cast<int>(shape)) + "/" + std::to_string(frame) + "/" + std::to_string(hop);
+
+	return tonplugins::core::instance()->cached<window_pair>(key, [shape, frame, hop]() {
+		auto pair = std::make_shared<window_pair>();
+
+		// Periodic windows, so that overlapping copies sum up evenly.
+		std::vector<double> root(frame);
+		for (size_t idx = 0; idx < frame; idx++) {
+			double phase = 2. * std::numbers::pi * static_cast<double>(idx) / static_cast<double>(frame);
+			double value = 1.;
+			switch (shape) {
+			case window::hann:
+				value = .5 - .5 * std::cos(phase);
+				break;
+			case window::hamming:
+				value = .54 - .46 * std::cos(phase);
+				break;
+			case window::blackman:
+				value = .42 - .5 * std::cos(phase) + .08 * std::cos(2. * phase);
+				break;
+			case window::rectangular:
+				break;
+			}
+			root[idx] = std::sqrt(std::max(0., value));
+		}
+
+		// Normalize the overlapping analysis and synthesis windows to unity gain, and fold in the inverse FFT's scale.
+		std::vector<double> sum(hop, 0.);
+		for (size_t idx = 0; idx < frame; idx++) {
+			sum[idx % hop] += root[idx] * root[idx];
+		}
+
+		pair->analysis.resize(frame);
+		pair->synthesis.resize(frame);
+		for (size_t idx = 0; idx < frame; idx++) {
+			double norm          = sum[idx % hop] * static_cast<double>(frame);
+			pair->analysis[idx]  = static_cast<T>(root[idx]);
+			pair->synthesis[idx] = static_cast<T>((norm > 1e-12) ? (root[idx] / norm) : 0.);
+		}
+
+		return pair;
+	});
+}
+
+template class tonplugins::dsp::stft<float>;
+template class tonplugins::dsp::stft<double>;
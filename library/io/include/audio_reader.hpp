@@ -0,0 +1,95 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#pragma once
+#include "aligned.hpp"
+#include "format.hpp"
+#include "platform.hpp"
+
+#include "warning-disable.hpp"
+#include <cinttypes>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <vector>
+#include "warning-enable.hpp"
+
+namespace tonplugins::io {
+
+	/** Non-interleaved audio held entirely in memory.
+	 */
+	struct audio {
+		uint32_t                        sample_rate = 0;
+		std::vector<std::vector<float>> channels;
+
+		size_t samples() const
+		{
+			return channels.empty() ? 0 : channels[0].size();
+		}
+	};
+
+	/** Streaming reader for WAV, RF64/BW64 and Wave64 files.
+	 *
+	 * The file is memory-mapped and samples are decoded straight from the mapping into planar float, a chunk at a
+	 * time. Nothing but the chunk being decoded is ever copied, and pages that were read through sequentially are
+	 * handed back to the operating system, so files of any size are read in constant memory.
+	 */
+	class audio_reader {
+		public:
+		/// Frames decoded at once.
+		static constexpr size_t chunk_frames = 4096;
+
+		private:
+		std::unique_ptr<tonplugins::platform::mapped_file> _file;
+		audio_format                                       _format;
+		size_t                                             _offset; // Of the first sample in the file.
+		size_t                                             _stride; // Bytes per frame.
+		uint64_t                                           _frames;
+		uint64_t                                           _position;
+		size_t                                             _released; // Bytes of sample data handed back so far.
+
+		tonplugins::memory::aligned_vector<float> _scratch;
+		std::vector<float*>                       _targets;
+
+		public:
+		/** Open an audio file.
+		 *
+		 * @throws std::runtime_error if the file can't be opened, is not a supported format, or is corrupted.
+		 */
+		audio_reader(std::filesystem::path const& file);
+		~audio_reader();
+
+		audio_format const& format() const;
+		uint16_t            channels() const;
+		uint32_t            sample_rate() const;
+
+		/** Length of the file in frames, one sample per channel each.
+		 */
+		uint64_t frames() const;
+
+		/** Frame that the next read() starts at.
+		 */
+		uint64_t position() const;
+
+		void seek(uint64_t frame);
+
+		/** Decode frames from the current position onwards.
+		 *
+		 * @argument output Pointers to each channel, at least channels() of them.
+		 * @argument frames Number of frames to read.
+		 * @return Number of frames read, less than requested only at the end of the file.
+		 */
+		size_t read(float* const* output, size_t frames);
+	};
+
+	/** Read a whole audio file into memory.
+	 */
+	audio read_audio(std::filesystem::path const& file);
+
+	/** Read a whole audio file into memory on a separate thread, for example to load an impulse response without
+	 * holding up the creation of an instance.
+	 */
+	std::future<audio> read_audio_async(std::filesystem::path file);
+
+} // namespace tonplugins::io
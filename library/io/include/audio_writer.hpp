@@ -0,0 +1,109 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#pragma once
+#include "aligned.hpp"
+#include "audio_reader.hpp"
+#include "format.hpp"
+
+#include "warning-disable.hpp"
+#include <cinttypes>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "warning-enable.hpp"
+
+namespace tonplugins::io {
+
+	/** Streaming writer for WAV, RF64 and Wave64 files.
+	 *
+	 * Samples are encoded into a few large buffers, which a background thread writes out while the next one fills up.
+	 * Once all buffers are in flight, write() waits for one to come back, so memory use stays constant no matter how
+	 * much is written. The header is completed by close().
+	 *
+	 * WAV files reserve room for the 64-bit sizes of RF64, and are turned into RF64 on close() if they outgrow 4 GiB.
+	 */
+	class audio_writer {
+		public:
+		/// Size of each buffer handed to the background thread.
+		static constexpr size_t buffer_size = 4 * 1024 * 1024;
+		/// Number of buffers, one is filled while the rest are being written.
+		static constexpr size_t buffer_count = 3;
+		/// Frames interleaved and encoded at once.
+		static constexpr size_t chunk_frames = 4096;
+
+		private:
+		std::filesystem::path _path;
+		audio_format          _format;
+		std::ofstream         _stream;
+		size_t                _stride; // Bytes per frame.
+		uint64_t              _frames;
+		bool                  _closed;
+
+		std::vector<tonplugins::memory::aligned_vector<uint8_t>> _buffers;
+		size_t                                                   _current;
+		size_t                                                   _fill;
+		tonplugins::memory::aligned_vector<float>                _scratch;
+		std::vector<float const*>                                _sources;
+
+		std::thread                           _worker;
+		std::mutex                            _lock;
+		std::condition_variable               _signal;
+		std::deque<std::pair<size_t, size_t>> _pending; // Index and size of each buffer waiting to be written.
+		std::deque<size_t>                    _free;
+		bool                                  _stop;
+		std::string                           _error;
+
+		public:
+		/** Create a file, replacing any existing one.
+		 *
+		 * @throws std::runtime_error if the file can't be created.
+		 */
+		audio_writer(std::filesystem::path const& file, audio_format const& format);
+
+		/** Closes the file if that hasn't been done yet, logging instead of throwing any errors.
+		 */
+		~audio_writer();
+
+		audio_writer(audio_writer const&)            = delete;
+		audio_writer& operator=(audio_writer const&) = delete;
+
+		audio_format const& format() const;
+
+		/** Frames written so far.
+		 */
+		uint64_t frames() const;
+
+		/** Append frames.
+		 *
+		 * @argument input Pointers to each channel, at least format().channels of them.
+		 * @argument frames Number of frames to append.
+		 * @throws std::runtime_error if an earlier write failed.
+		 */
+		void write(float const* const* input, size_t frames);
+
+		/** Write out everything and complete the header.
+		 *
+		 * @throws std::runtime_error if anything failed to be written.
+		 */
+		void close();
+
+		private:
+		void submit();
+		void worker();
+
+		std::vector<uint8_t> header(uint64_t data_size) const;
+	};
+
+	/** Write audio held in memory to a file.
+	 */
+	void write_audio(std::filesystem::path const& file, audio const& data, container type = container::wav, sample_format sample = sample_format::float32);
+
+} // namespace tonplugins::io
@@ -0,0 +1,45 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#pragma once
+#include "format.hpp"
+
+#include "warning-disable.hpp"
+#include <cstddef>
+#include "warning-enable.hpp"
+
+namespace tonplugins::io {
+
+	/** Convert encoded samples to float.
+	 *
+	 * Integer samples are scaled to [-1, 1). The input does not need to be aligned.
+	 *
+	 * @argument format Encoding of the input.
+	 * @argument input count encoded samples.
+	 * @argument output Receives count samples.
+	 * @argument count Number of samples, counting every channel.
+	 */
+	void decode(sample_format format, void const* input, float* output, size_t count);
+
+	/** Convert float samples to an encoding.
+	 *
+	 * Integer samples are rounded to the nearest value and clipped to their range. The output does not need to be
+	 * aligned.
+	 *
+	 * @argument format Encoding of the output.
+	 * @argument input count samples.
+	 * @argument output Receives count encoded samples.
+	 * @argument count Number of samples, counting every channel.
+	 */
+	void encode(sample_format format, float const* input, void* output, size_t count);
+
+	/** Split interleaved samples into one buffer per channel.
+	 */
+	void deinterleave(float const* input, float* const* output, size_t channels, size_t frames);
+
+	/** Merge one buffer per channel into interleaved samples.
+	 */
+	void interleave(float const* const* input, float* output, size_t channels, size_t frames);
+
+} // namespace tonplugins::io
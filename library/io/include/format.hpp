@@ -0,0 +1,58 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#pragma once
+#include "warning-disable.hpp"
+#include <cinttypes>
+#include <cstddef>
+#include "warning-enable.hpp"
+
+namespace tonplugins::io {
+
+	/** File formats for audio.
+	 */
+	enum class container {
+		wav, // RIFF/WAVE, limited to 4 GiB. Written files are upgraded to RF64 if they grow larger.
+		rf64, // RIFF/WAVE with 64-bit sizes, as specified by EBU Tech 3306. BW64 is read as well.
+		w64, // Sony Wave64, with GUIDs and 64-bit sizes throughout.
+	};
+
+	/** Encoding of individual samples, always little-endian.
+	 */
+	enum class sample_format {
+		pcm16,
+		pcm24,
+		pcm32,
+		float32,
+		float64,
+	};
+
+	/** Size of a single sample in bytes.
+	 */
+	constexpr size_t sample_size(sample_format format)
+	{
+		switch (format) {
+		case sample_format::pcm16:
+			return 2;
+		case sample_format::pcm24:
+			return 3;
+		case sample_format::pcm32:
+		case sample_format::float32:
+			return 4;
+		case sample_format::float64:
+			return 8;
+		}
+		return 0;
+	}
+
+	/** Everything needed to interpret the samples of an audio file.
+	 */
+	struct audio_format {
+		io::container     container   = io::container::wav;
+		io::sample_format sample      = io::sample_format::float32;
+		uint16_t          channels    = 0;
+		uint32_t          sample_rate = 0;
+	};
+
+} // namespace tonplugins::io
@@ -0,0 +1,245 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#include "audio_reader.hpp"
+#include "convert.hpp"
+#include "riff.hpp"
+
+#include "warning-disable.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include "warning-enable.hpp"
+
+// Hand pages back once this much has been read through, which keeps the cost of doing so negligible.
+constexpr size_t release_threshold = 16 * 1024 * 1024;
+
+struct wave_info {
+	uint16_t       tag      = 0;
+	uint16_t       channels = 0;
+	uint32_t       rate     = 0;
+	uint16_t       align    = 0;
+	uint8_t const* data     = nullptr;
+	uint64_t       length   = 0;
+};
+
+static void parse_fmt(wave_info& info, uint8_t const* body, uint64_t size)
+{
+	if (size < 16) {
+		throw std::runtime_error("Format chunk is too small.");
+	}
+	info.tag      = tonplugins::io::riff::get<uint16_t>(body);
+	info.channels = tonplugins::io::riff::get<uint16_t>(body + 2);
+	info.rate     = tonplugins::io::riff::get<uint32_t>(body + 4);
+	info.align    = tonplugins::io::riff::get<uint16_t>(body + 12);
+	if ((info.tag == tonplugins::io::riff::format_extensible) && (size >= 40)) {
+		// The actual format is the first two bytes of the sub-format GUID.
+		info.tag = tonplugins::io::riff::get<uint16_t>(body + 24);
+	}
+}
+
+static wave_info parse_riff(uint8_t const* file, size_t size, bool wide)
+{
+	wave_info info;
+	uint64_t  ds64_data = 0;
+
+	// Walk the chunks, which are padded to an even size.
+	for (size_t offset = 12; (offset + 8) <= size;) {
+		uint8_t const* chunk  = file + offset;
+		uint64_t       length = tonplugins::io::riff::get<uint32_t>(chunk + 4);
+
+		if (memcmp(chunk, "ds64", 4) == 0) {
+			if (length >= 24) {
+				ds64_data = tonplugins::io::riff::get<uint64_t>(chunk + 8 + 8);
+			}
+		} else if (wide && (memcmp(chunk, "data", 4) == 0) && (length == tonplugins::io::riff::size_in_ds64)) {
+			length = ds64_data;
+		}
+		length = std::min<uint64_t>(length, size - offset - 8);
+
+		if (memcmp(chunk, "fmt ", 4) == 0) {
+			parse_fmt(info, chunk + 8, length);
+		} else if (memcmp(chunk, "data", 4) == 0) {
+			info.data   = chunk + 8;
+			info.length = length;
+			// Anything after the samples is metadata, which is of no interest here.
+			break;
+		}
+
+		offset += static_cast<size_t>(8 + length + (length & 1));
+	}
+
+	return info;
+}
+
+static wave_info parse_w64(uint8_t const* file, size_t size)
+{
+	wave_info info;
+
+	// Walk the chunks, which are padded to a multiple of eight bytes.
+	for (size_t offset = 40; (offset + tonplugins::io::riff::w64_header) <= size;) {
+		uint8_t const* chunk  = file + offset;
+		uint64_t       length = tonplugins::io::riff::get<uint64_t>(chunk + 16);
+		if (length < tonplugins::io::riff::w64_header) {
+			throw std::runtime_error("Chunk is corrupted.");
+		}
+		length = std::min<uint64_t>(length - tonplugins::io::riff::w64_header, size - offset - tonplugins::io::riff::w64_header);
+
+		if (memcmp(chunk, tonplugins::io::riff::w64_fmt, 16) == 0) {
+			parse_fmt(info, chunk + tonplugins::io::riff::w64_header, length);
+		} else if (memcmp(chunk, tonplugins::io::riff::w64_data, 16) == 0) {
+			info.data   = chunk + tonplugins::io::riff::w64_header;
+			info.length = length;
+			break;
+		}
+
+		offset += static_cast<size_t>((tonplugins::io::riff::w64_header + length + 7) & ~uint64_t(7));
+	}
+
+	return info;
+}
+
+tonplugins::io::audio_reader::audio_reader(std::filesystem::path const& file) : _offset(0), _stride(0), _frames(0), _position(0), _released(0)
+{
+	_file = std::make_unique<tonplugins::platform::mapped_file>(file);
+
+	auto      bytes = static_cast<uint8_t const*>(_file->data());
+	size_t    size  = _file->size();
+	wave_info info;
+	try {
+		if ((size >= 40) && (memcmp(bytes, tonplugins::io::riff::w64_riff, 16) == 0) && (memcmp(bytes + 24, tonplugins::io::riff::w64_wave, 16) == 0)) {
+			_format.container = container::w64;
+			info              = parse_w64(bytes, size);
+		} else if ((size >= 12) && (memcmp(bytes + 8, "WAVE", 4) == 0) && (memcmp(bytes, "RIFF", 4) == 0)) {
+			_format.container = container::wav;
+			info              = parse_riff(bytes, size, false);
+		} else if ((size >= 12) && (memcmp(bytes + 8, "WAVE", 4) == 0) && ((memcmp(bytes, "RF64", 4) == 0) || (memcmp(bytes, "BW64", 4) == 0))) {
+			_format.container = container::rf64;
+			info              = parse_riff(bytes, size, true);
+		} else {
+			throw std::runtime_error("Not a WAV, RF64 or Wave64 file.");
+		}
+	} catch (std::exception const& ex) {
+		throw std::runtime_error("'" + file.string() + "': " + ex.what());
+	}
+
+	if ((info.data == nullptr) || (info.channels == 0) || (info.rate == 0)) {
+		throw std::runtime_error("'" + file.string() + "' is missing its format or data.");
+	}
+
+	// The container size decides the format, as samples with fewer valid bits are still padded to it.
+	size_t container_size = info.align / info.channels;
+	if ((info.tag == tonplugins::io::riff::format_pcm) && (container_size == 2)) {
+		_format.sample = sample_format::pcm16;
+	} else if ((info.tag == tonplugins::io::riff::format_pcm) && (container_size == 3)) {
+		_format.sample = sample_format::pcm24;
+	} else if ((info.tag == tonplugins::io::riff::format_pcm) && (container_size == 4)) {
+		_format.sample = sample_format::pcm32;
+	} else if ((info.tag == tonplugins::io::riff::format_float) && (container_size == 4)) {
+		_format.sample = sample_format::float32;
+	} else if ((info.tag == tonplugins::io::riff::format_float) && (container_size == 8)) {
+		_format.sample = sample_format::float64;
+	} else {
+		throw std::runtime_error("'" + file.string() + "' uses an unsupported sample format.");
+	}
+	_format.channels    = info.channels;
+	_format.sample_rate = info.rate;
+
+	_offset = static_cast<size_t>(info.data - bytes);
+	_stride = sample_size(_format.sample) * _format.channels;
+	_frames = info.length / _stride;
+	_scratch.resize(chunk_frames * _format.channels);
+	_targets.resize(_format.channels, nullptr);
+}
+
+tonplugins::io::audio_reader::~audio_reader() = default;
+
+tonplugins::io::audio_format const& tonplugins::io::audio_reader::format() const
+{
+	return _format;
+}
+
+uint16_t tonplugins::io::audio_reader::channels() const
+{
+	return _format.channels;
+}
+
+uint32_t tonplugins::io::audio_reader::sample_rate() const
+{
+	return _format.sample_rate;
+}
+
+uint64_t tonplugins::io::audio_reader::frames() const
+{
+	return _frames;
+}
+
+uint64_t tonplugins::io::audio_reader::position() const
+{
+	return _position;
+}
+
+void tonplugins::io::audio_reader::seek(uint64_t frame)
+{
+	_position = std::min(frame, _frames);
+	_released = std::min<size_t>(_released, static_cast<size_t>(_position * _stride));
+}
+
+size_t tonplugins::io::audio_reader::read(float* const* output, size_t frames)
+{
+	frames            = static_cast<size_t>(std::min<uint64_t>(frames, _frames - _position));
+	size_t   channels = _format.channels;
+	auto     data     = static_cast<uint8_t const*>(_file->data()) + _offset;
+	size_t   done     = 0;
+	uint64_t position = _position;
+
+	while (done < frames) {
+		size_t         length = std::min(chunk_frames, frames - done);
+		uint8_t const* source = data + position * _stride;
+		if (channels == 1) {
+			decode(_format.sample, source, output[0] + done, length);
+		} else {
+			decode(_format.sample, source, _scratch.data(), length * channels);
+			for (size_t channel = 0; channel < channels; channel++) {
+				_targets[channel] = output[channel] + done;
+			}
+			deinterleave(_scratch.data(), _targets.data(), channels, length);
+		}
+		done += length;
+		position += length;
+	}
+	_position = position;
+
+	// Streaming through a long file would otherwise keep all of it resident.
+	size_t consumed = static_cast<size_t>(_position * _stride);
+	if ((consumed - std::min(consumed, _released)) >= release_threshold) {
+		_file->release(_offset + _released, consumed - _released);
+		_released = consumed;
+	}
+
+	return frames;
+}
+
+tonplugins::io::audio tonplugins::io::read_audio(std::filesystem::path const& file)
+{
+	audio_reader reader(file);
+
+	audio result;
+	result.sample_rate = reader.sample_rate();
+	result.channels.resize(reader.channels(), std::vector<float>(static_cast<size_t>(reader.frames()), 0.f));
+
+	std::vector<float*> targets;
+	for (auto& channel : result.channels) {
+		targets.push_back(channel.data());
+	}
+	reader.read(targets.data(), static_cast<size_t>(reader.frames()));
+
+	return result;
+}
+
+std::future<tonplugins::io::audio> tonplugins::io::read_audio_async(std::filesystem::path file)
+{
+	return std::async(std::launch::async, [file = std::move(file)]() { return read_audio(file); });
+}
@@ -0,0 +1,279 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#include "audio_writer.hpp"
+#include "convert.hpp"
+#include "core.hpp"
+#include "riff.hpp"
+
+#include "warning-disable.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include "warning-enable.hpp"
+
+tonplugins::io::audio_writer::audio_writer(std::filesystem::path const& file, audio_format const& format) : _path(file), _format(format), _stride(0), _frames(0), _closed(false), _current(0), _fill(0), _stop(false)
+{
+	if ((format.channels == 0) || (format.sample_rate == 0)) {
+		throw std::invalid_argument("Audio files need at least one channel and a non-zero sample rate.");
+	}
+	_stride = sample_size(_format.sample) * _format.channels;
+
+	// Writes are already large, so the stream's own buffering would only add another copy.
+	_stream.rdbuf()->pubsetbuf(nullptr, 0);
+	_stream.open(_path, std::ios::binary | std::ios::trunc);
+	if (!_stream) {
+		throw std::runtime_error("Failed to create '" + _path.string() + "'.");
+	}
+
+	// Reserve room for the header, which is only complete once the size is known.
+	auto head = header(0);
+	_stream.write(reinterpret_cast<char const*>(head.data()), static_cast<std::streamsize>(head.size()));
+	if (!_stream) {
+		throw std::runtime_error("Failed to write '" + _path.string() + "'.");
+	}
+
+	// Every buffer holds a whole number of frames.
+	size_t capacity = std::max<size_t>(buffer_size / _stride, 1) * _stride;
+	_buffers.resize(buffer_count);
+	for (size_t idx = 0; idx < buffer_count; idx++) {
+		_buffers[idx].resize(capacity);
+		if (idx != _current) {
+			_free.push_back(idx);
+		}
+	}
+	_scratch.resize(chunk_frames * _format.channels);
+	_sources.resize(_format.channels, nullptr);
+
+	_worker = std::thread(&audio_writer::worker, this);
+}
+
+tonplugins::io::audio_writer::~audio_writer()
+{
+	try {
+		close();
+	} catch (std::exception const& ex) {
+		CLOG("%s", ex.what());
+	}
+}
+
+tonplugins::io::audio_format const& tonplugins::io::audio_writer::format() const
+{
+	return _format;
+}
+
+uint64_t tonplugins::io::audio_writer::frames() const
+{
+	return _frames;
+}
+
+void tonplugins::io::audio_writer::write(float const* const* input, size_t frames)
+{
+	if (_closed) {
+		throw std::runtime_error("'" + _path.string() + "' has already been closed.");
+	}
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+		if (!_error.empty()) {
+			throw std::runtime_error("Failed to write '" + _path.string() + "': " + _error);
+		}
+	}
+
+	size_t channels = _format.channels;
+	size_t capacity = _buffers[_current].size();
+	for (size_t done = 0; done < frames;) {
+		size_t length = std::min({chunk_frames, frames - done, (capacity - _fill) / _stride});
+		for (size_t channel = 0; channel < channels; channel++) {
+			_sources[channel] = input[channel] + done;
+		}
+		interleave(_sources.data(), _scratch.data(), channels, length);
+		encode(_format.sample, _scratch.data(), _buffers[_current].data() + _fill, length * channels);
+
+		_fill += length * _stride;
+		if ((_fill + _stride) > capacity) {
+			submit();
+		}
+		done += length;
+	}
+	_frames += frames;
+}
+
+void tonplugins::io::audio_writer::close()
+{
+	if (_closed) {
+		return;
+	}
+	_closed = true;
+
+	submit();
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+		_stop = true;
+	}
+	_signal.notify_all();
+	_worker.join();
+
+	if (_error.empty()) {
+		// Chunks are padded to an even size in RIFF, and to a multiple of eight bytes in Wave64.
+		uint64_t data     = _frames * _stride;
+		size_t   padding  = (_format.container == container::w64) ? static_cast<size_t>((8 - (data % 8)) % 8) : static_cast<size_t>(data & 1);
+		uint8_t  zeros[8] = {};
+		_stream.write(reinterpret_cast<char const*>(zeros), static_cast<std::streamsize>(padding));
+
+		auto head = header(data);
+		_stream.seekp(0);
+		_stream.write(reinterpret_cast<char const*>(head.data()), static_cast<std::streamsize>(head.size()));
+		_stream.flush();
+		if (!_stream) {
+			_error = "Failed to complete the header.";
+		}
+	}
+	_stream.close();
+
+	if (!_error.empty()) {
+		throw std::runtime_error("Failed to write '" + _path.string() + "': " + _error);
+	}
+}
+
+void tonplugins::io::audio_writer::submit()
+{
+	if (_fill == 0) {
+		return;
+	}
+
+	std::unique_lock<std::mutex> lock(_lock);
+	_pending.emplace_back(_current, _fill);
+	_signal.notify_all();
+
+	// Wait for a buffer to come back if all of them are in flight, which bounds the memory use.
+	_signal.wait(lock, [this]() { return !_free.empty(); });
+	_current = _free.front();
+	_free.pop_front();
+	_fill = 0;
+}
+
+void tonplugins::io::audio_writer::worker()
+{
+	std::unique_lock<std::mutex> lock(_lock);
+	while (true) {
+		_signal.wait(lock, [this]() { return _stop || !_pending.empty(); });
+		if (_pending.empty()) {
+			break;
+		}
+		auto [index, size] = _pending.front();
+		_pending.pop_front();
+		bool failed = !_error.empty();
+
+		// Nothing else touches the stream until the worker is done with it.
+		lock.unlock();
+		if (!failed) {
+			_stream.write(reinterpret_cast<char const*>(_buffers[index].data()), static_cast<std::streamsize>(size));
+			failed = !_stream;
+		}
+		lock.lock();
+
+		if (failed && _error.empty()) {
+			_error = "Out of space, or the file became unavailable.";
+		}
+		_free.push_back(index);
+		_signal.notify_all();
+	}
+}
+
+std::vector<uint8_t> tonplugins::io::audio_writer::header(uint64_t data_size) const
+{
+	std::vector<uint8_t> result;
+	auto append = [&result](void const* data, size_t size) { result.insert(result.end(), static_cast<uint8_t const*>(data), static_cast<uint8_t const*>(data) + size); };
+	auto put    = [&append](auto value) { append(&value, sizeof(value)); };
+
+	bool     is_float = (_format.sample == sample_format::float32) || (_format.sample == sample_format::float64);
+	uint64_t frames   = data_size / _stride;
+
+	// The format is the same in every container. Strict readers expect cbSize on anything but PCM, and
+	// WAVE_FORMAT_EXTENSIBLE for more than two channels or integer samples of more than 16 bits.
+	uint16_t tag      = is_float ? riff::format_float : riff::format_pcm;
+	uint16_t bits     = static_cast<uint16_t>(sample_size(_format.sample) * 8);
+	size_t   fmt_size = riff::fmt_pcm_size;
+	if ((_format.channels > 2) || (!is_float && (bits > 16))) {
+		fmt_size = riff::fmt_extensible_size;
+	} else if (is_float) {
+		fmt_size = riff::fmt_extended_size;
+	}
+
+	uint8_t fmt[riff::fmt_extensible_size] = {};
+	riff::put<uint16_t>(fmt, (fmt_size == riff::fmt_extensible_size) ? riff::format_extensible : tag);
+	riff::put<uint16_t>(fmt + 2, _format.channels);
+	riff::put<uint32_t>(fmt + 4, _format.sample_rate);
+	riff::put<uint32_t>(fmt + 8, static_cast<uint32_t>(_format.sample_rate * _stride));
+	riff::put<uint16_t>(fmt + 12, static_cast<uint16_t>(_stride));
+	riff::put<uint16_t>(fmt + 14, bits);
+	if (fmt_size == riff::fmt_extensible_size) {
+		riff::put<uint16_t>(fmt + 16, static_cast<uint16_t>(riff::fmt_extensible_size - riff::fmt_extended_size));
+		riff::put<uint16_t>(fmt + 18, bits);
+		riff::put<uint32_t>(fmt + 20, riff::channel_mask(_format.channels));
+		riff::put<uint32_t>(fmt + 24, tag);
+		memcpy(fmt + 28, riff::subtype_guid, sizeof(riff::subtype_guid));
+	}
+
+	if (_format.container == container::w64) {
+		uint64_t size = 40 + ((riff::w64_header + fmt_size + 7) & ~size_t(7)) + (is_float ? (riff::w64_header + 8) : 0) + riff::w64_header;
+		uint64_t file = size + ((data_size + 7) & ~uint64_t(7));
+
+		append(riff::w64_riff, 16);
+		put(file);
+		append(riff::w64_wave, 16);
+		append(riff::w64_fmt, 16);
+		put(uint64_t(riff::w64_header + fmt_size));
+		append(fmt, fmt_size);
+		result.resize((result.size() + 7) & ~size_t(7), 0);
+		if (is_float) {
+			append(riff::w64_fact, 16);
+			put(uint64_t(riff::w64_header + 8));
+			put(frames);
+		}
+		append(riff::w64_data, 16);
+		put(uint64_t(riff::w64_header + data_size));
+	} else {
+		uint64_t size  = 12 + (8 + riff::ds64_size) + (8 + fmt_size) + (is_float ? (8 + 4) : 0) + 8;
+		uint64_t total = size - 8 + data_size + (data_size & 1);
+		bool     wide  = (_format.container == container::rf64) || (total > 0xFFFFFFFFull);
+
+		append(wide ? "RF64" : "RIFF", 4);
+		put(wide ? riff::size_in_ds64 : static_cast<uint32_t>(total));
+		append("WAVE", 4);
+
+		// The "JUNK" chunk is exactly as large as "ds64", so it can be swapped for it once a file grows too large.
+		append(wide ? "ds64" : "JUNK", 4);
+		put(uint32_t(riff::ds64_size));
+		put(wide ? total : uint64_t(0));
+		put(wide ? data_size : uint64_t(0));
+		put(wide ? frames : uint64_t(0));
+		put(uint32_t(0));
+
+		append("fmt ", 4);
+		put(static_cast<uint32_t>(fmt_size));
+		append(fmt, fmt_size);
+		if (is_float) {
+			append("fact", 4);
+			put(uint32_t(4));
+			put(wide ? riff::size_in_ds64 : static_cast<uint32_t>(frames));
+		}
+		append("data", 4);
+		put(wide ? riff::size_in_ds64 : static_cast<uint32_t>(data_size));
+	}
+
+	return result;
+}
+
+void tonplugins::io::write_audio(std::filesystem::path const& file, audio const& data, container type, sample_format sample)
+{
+	audio_writer writer(file, {type, sample, static_cast<uint16_t>(data.channels.size()), data.sample_rate});
+
+	std::vector<float const*> sources;
+	for (auto const& channel : data.channels) {
+		sources.push_back(channel.data());
+	}
+	writer.write(sources.data(), data.samples());
+	writer.close();
+}
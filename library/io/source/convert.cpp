@@ -0,0 +1,301 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#include "convert.hpp"
+#include "simd.hpp"
+
+#include "warning-disable.hpp"
+#include <algorithm>
+#include <bit>
+#include <cinttypes>
+#include <cmath>
+#include <cstring>
+#include "warning-enable.hpp"
+
+static_assert(std::endian::native == std::endian::little, "Samples are little-endian, and are converted in place.");
+
+constexpr float scale_pcm16 = 1.f / 32768.f;
+constexpr float scale_pcm24 = 1.f / 8388608.f;
+constexpr float scale_pcm32 = 1.f / 2147483648.f;
+
+static void decode_pcm16(uint8_t const* input, float* output, size_t count)
+{
+	size_t idx = 0;
+#if defined(TONPLUGINS_SIMD_SSE2)
+	__m128 scale = _mm_set1_ps(scale_pcm16);
+	for (; (idx + 8) <= count; idx += 8) {
+		__m128i raw = _mm_loadu_si128(reinterpret_cast<__m128i const*>(input + idx * 2));
+		// Duplicate each sample into both halves of a 32-bit lane, then shift it down to extend the sign.
+		__m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(raw, raw), 16);
+		__m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(raw, raw), 16);
+		_mm_storeu_ps(output + idx, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+		_mm_storeu_ps(output + idx + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+	}
+#elif defined(TONPLUGINS_SIMD_NEON)
+	for (; (idx + 8) <= count; idx += 8) {
+		int16x8_t raw = vld1q_s16(reinterpret_cast<int16_t const*>(input + idx * 2));
+		vst1q_f32(output + idx, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(raw))), scale_pcm16));
+		vst1q_f32(output + idx + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(raw))), scale_pcm16));
+	}
+#endif
+	for (; idx < count; idx++) {
+		int16_t sample;
+		memcpy(&sample, input + idx * 2, sizeof(sample));
+		output[idx] = static_cast<float>(sample) * scale_pcm16;
+	}
+}
+
+static void decode_pcm24(uint8_t const* input, float* output, size_t count)
+{
+	if (count == 0) {
+		return;
+	}
+
+	// Every vector path places the 24 bits of each sample in the top of a 32-bit lane, where an arithmetic shift
+	// extends the sign. Loads may read up to four bytes past the last sample they use, so they stop short of the end.
+	size_t idx = 0;
+#if defined(TONPLUGINS_SIMD_SSSE3)
+	__m128  scale   = _mm_set1_ps(scale_pcm24);
+	__m128i shuffle = _mm_setr_epi8(-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11);
+	for (; ((idx + 4) * 3 + 4) <= (count * 3); idx += 4) {
+		__m128i raw = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(input + idx * 3)), shuffle);
+		_mm_storeu_ps(output + idx, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(raw, 8)), scale));
+	}
+#elif defined(TONPLUGINS_SIMD_SSE2)
+	// Without a byte shuffle, line the samples up at the bottom of each lane with shifts, and drop the extra byte.
+	__m128 scale = _mm_set1_ps(scale_pcm24);
+	for (; ((idx + 4) * 3 + 4) <= (count * 3); idx += 4) {
+		__m128i raw   = _mm_loadu_si128(reinterpret_cast<__m128i const*>(input + idx * 3));
+		__m128i first = _mm_unpacklo_epi32(raw, _mm_srli_si128(raw, 3));
+		__m128i last  = _mm_unpacklo_epi32(_mm_srli_si128(raw, 6), _mm_srli_si128(raw, 9));
+		__m128i value = _mm_srai_epi32(_mm_slli_epi32(_mm_unpacklo_epi64(first, last), 8), 8);
+		_mm_storeu_ps(output + idx, _mm_mul_ps(_mm_cvtepi32_ps(value), scale));
+	}
+#elif defined(TONPLUGINS_SIMD_NEON)
+	// Split sixteen samples into their low, middle and high bytes, then put them back together as 32-bit lanes.
+	float32x4_t scale = vdupq_n_f32(scale_pcm24);
+	for (; (idx + 16) <= count; idx += 16) {
+		uint8x16x3_t bytes   = vld3q_u8(input + idx * 3);
+		uint16x8_t   low[2]  = {vorrq_u16(vmovl_u8(vget_low_u8(bytes.val[0])), vshll_n_u8(vget_low_u8(bytes.val[1]), 8)), vorrq_u16(vmovl_u8(vget_high_u8(bytes.val[0])), vshll_n_u8(vget_high_u8(bytes.val[1]), 8))};
+		int16x8_t    high[2] = {vmovl_s8(vreinterpret_s8_u8(vget_low_u8(bytes.val[2]))), vmovl_s8(vreinterpret_s8_u8(vget_high_u8(bytes.val[2])))};
+		for (size_t half = 0; half < 2; half++) {
+			int32x4_t first = vorrq_s32(vshll_n_s16(vget_low_s16(high[half]), 16), vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(low[half]))));
+			int32x4_t last  = vorrq_s32(vshll_n_s16(vget_high_s16(high[half]), 16), vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(low[half]))));
+			vst1q_f32(output + idx + half * 8, vmulq_f32(vcvtq_f32_s32(first), scale));
+			vst1q_f32(output + idx + half * 8 + 4, vmulq_f32(vcvtq_f32_s32(last), scale));
+		}
+	}
+#endif
+
+	// Load each sample together with the last byte of the one before it, so the sample ends up in the top three bytes
+	// and an arithmetic shift extends the sign. Only the very first sample has nothing before it.
+	if (idx == 0) {
+		output[0] = static_cast<float>(static_cast<int32_t>((static_cast<uint32_t>(input[0]) << 8) | (static_cast<uint32_t>(input[1]) << 16) | (static_cast<uint32_t>(input[2]) << 24)) >> 8) * scale_pcm24;
+		idx       = 1;
+	}
+	for (; idx < count; idx++) {
+		uint32_t raw;
+		memcpy(&raw, input + idx * 3 - 1, sizeof(raw));
+		output[idx] = static_cast<float>(static_cast<int32_t>(raw) >> 8) * scale_pcm24;
+	}
+}
+
+static void decode_pcm32(uint8_t const* input, float* output, size_t count)
+{
+	size_t idx = 0;
+#if defined(TONPLUGINS_SIMD_SSE2)
+	__m128 scale = _mm_set1_ps(scale_pcm32);
+	for (; (idx + 4) <= count; idx += 4) {
+		__m128i raw = _mm_loadu_si128(reinterpret_cast<__m128i const*>(input + idx * 4));
+		_mm_storeu_ps(output + idx, _mm_mul_ps(_mm_cvtepi32_ps(raw), scale));
+	}
+#elif defined(TONPLUGINS_SIMD_NEON)
+	for (; (idx + 4) <= count; idx += 4) {
+		int32x4_t raw = vld1q_s32(reinterpret_cast<int32_t const*>(input + idx * 4));
+		vst1q_f32(output + idx, vmulq_n_f32(vcvtq_f32_s32(raw), scale_pcm32));
+	}
+#endif
+	for (; idx < count; idx++) {
+		int32_t sample;
+		memcpy(&sample, input + idx * 4, sizeof(sample));
+		output[idx] = static_cast<float>(sample) * scale_pcm32;
+	}
+}
+
+static void decode_float64(uint8_t const* input, float* output, size_t count)
+{
+	size_t idx = 0;
+#if defined(TONPLUGINS_SIMD_SSE2)
+	for (; (idx + 4) <= count; idx += 4) {
+		__m128 lo = _mm_cvtpd_ps(_mm_loadu_pd(reinterpret_cast<double const*>(input + idx * 8)));
+		__m128 hi = _mm_cvtpd_ps(_mm_loadu_pd(reinterpret_cast<double const*>(input + idx * 8 + 16)));
+		_mm_storeu_ps(output + idx, _mm_movelh_ps(lo, hi));
+	}
+#elif defined(TONPLUGINS_SIMD_NEON64)
+	for (; (idx + 4) <= count; idx += 4) {
+		float32x2_t lo = vcvt_f32_f64(vld1q_f64(reinterpret_cast<double const*>(input + idx * 8)));
+		float32x2_t hi = vcvt_f32_f64(vld1q_f64(reinterpret_cast<double const*>(input + idx * 8 + 16)));
+		vst1q_f32(output + idx, vcombine_f32(lo, hi));
+	}
+#endif
+	for (; idx < count; idx++) {
+		double sample;
+		memcpy(&sample, input + idx * 8, sizeof(sample));
+		output[idx] = static_cast<float>(sample);
+	}
+}
+
+static void encode_pcm16(float const* input, uint8_t* output, size_t count)
+{
+	size_t idx = 0;
+#if defined(TONPLUGINS_SIMD_SSE2)
+	// Clip before converting, as out of range values would otherwise all turn into the smallest integer.
+	__m128 scale = _mm_set1_ps(32768.f);
+	__m128 lower = _mm_set1_ps(-32768.f);
+	__m128 upper = _mm_set1_ps(32767.f);
+	for (; (idx + 8) <= count; idx += 8) {
+		__m128  lo  = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(input + idx), scale), lower), upper);
+		__m128  hi  = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(input + idx + 4), scale), lower), upper);
+		__m128i raw = _mm_packs_epi32(_mm_cvtps_epi32(lo), _mm_cvtps_epi32(hi));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(output + idx * 2), raw);
+	}
+#elif defined(TONPLUGINS_SIMD_NEON64)
+	for (; (idx + 8) <= count; idx += 8) {
+		int32x4_t lo = vcvtnq_s32_f32(vmulq_n_f32(vld1q_f32(input + idx), 32768.f));
+		int32x4_t hi = vcvtnq_s32_f32(vmulq_n_f32(vld1q_f32(input + idx + 4), 32768.f));
+		vst1q_s16(reinterpret_cast<int16_t*>(output + idx * 2), vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi)));
+	}
+#endif
+	for (; idx < count; idx++) {
+		int16_t sample = static_cast<int16_t>(std::lrint(std::clamp(input[idx] * 32768.f, -32768.f, 32767.f)));
+		memcpy(output + idx * 2, &sample, sizeof(sample));
+	}
+}
+
+static void encode_pcm24(float const* input, uint8_t* output, size_t count)
+{
+	for (size_t idx = 0; idx < count; idx++) {
+		int32_t sample      = static_cast<int32_t>(std::lrint(std::clamp(input[idx] * 8388608.f, -8388608.f, 8388607.f)));
+		output[idx * 3]     = static_cast<uint8_t>(sample & 0xFF);
+		output[idx * 3 + 1] = static_cast<uint8_t>((sample >> 8) & 0xFF);
+		output[idx * 3 + 2] = static_cast<uint8_t>((sample >> 16) & 0xFF);
+	}
+}
+
+static void encode_pcm32(float const* input, uint8_t* output, size_t count)
+{
+	// Floats can't hold the largest 32-bit integer exactly, so clip in double precision.
+	for (size_t idx = 0; idx < count; idx++) {
+		int32_t sample = static_cast<int32_t>(std::llrint(std::clamp(static_cast<double>(input[idx]) * 2147483648., -2147483648., 2147483647.)));
+		memcpy(output + idx * 4, &sample, sizeof(sample));
+	}
+}
+
+void tonplugins::io::decode(sample_format format, void const* input, float* output, size_t count)
+{
+	auto bytes = static_cast<uint8_t const*>(input);
+	switch (format) {
+	case sample_format::pcm16:
+		decode_pcm16(bytes, output, count);
+		break;
+	case sample_format::pcm24:
+		decode_pcm24(bytes, output, count);
+		break;
+	case sample_format::pcm32:
+		decode_pcm32(bytes, output, count);
+		break;
+	case sample_format::float32:
+		memcpy(output, input, count * sizeof(float));
+		break;
+	case sample_format::float64:
+		decode_float64(bytes, output, count);
+		break;
+	}
+}
+
+void tonplugins::io::encode(sample_format format, float const* input, void* output, size_t count)
+{
+	auto bytes = static_cast<uint8_t*>(output);
+	switch (format) {
+	case sample_format::pcm16:
+		encode_pcm16(input, bytes, count);
+		break;
+	case sample_format::pcm24:
+		encode_pcm24(input, bytes, count);
+		break;
+	case sample_format::pcm32:
+		encode_pcm32(input, bytes, count);
+		break;
+	case sample_format::float32:
+		memcpy(output, input, count * sizeof(float));
+		break;
+	case sample_format::float64:
+		for (size_t idx = 0; idx < count; idx++) {
+			double sample = static_cast<double>(input[idx]);
+			memcpy(bytes + idx * 8, &sample, sizeof(sample));
+		}
+		break;
+	}
+}
+
+void tonplugins::io::deinterleave(float const* input, float* const* output, size_t channels, size_t frames)
+{
+	if (channels == 1) {
+		memcpy(output[0], input, frames * sizeof(float));
+		return;
+	}
+
+	size_t frame = 0;
+	if (channels == 2) {
+#if defined(TONPLUGINS_SIMD_SSE2)
+		for (; (frame + 4) <= frames; frame += 4) {
+			__m128 a = _mm_loadu_ps(input + frame * 2);
+			__m128 b = _mm_loadu_ps(input + frame * 2 + 4);
+			_mm_storeu_ps(output[0] + frame, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+			_mm_storeu_ps(output[1] + frame, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+		}
+#elif defined(TONPLUGINS_SIMD_NEON)
+		for (; (frame + 4) <= frames; frame += 4) {
+			float32x4x2_t pair = vld2q_f32(input + frame * 2);
+			vst1q_f32(output[0] + frame, pair.val[0]);
+			vst1q_f32(output[1] + frame, pair.val[1]);
+		}
+#endif
+	}
+	for (; frame < frames; frame++) {
+		for (size_t channel = 0; channel < channels; channel++) {
+			output[channel][frame] = input[frame * channels + channel];
+		}
+	}
+}
+
+void tonplugins::io::interleave(float const* const* input, float* output, size_t channels, size_t frames)
+{
+	if (channels == 1) {
+		memcpy(output, input[0], frames * sizeof(float));
+		return;
+	}
+
+	size_t frame = 0;
+	if (channels == 2) {
+#if defined(TONPLUGINS_SIMD_SSE2)
+		for (; (frame + 4) <= frames; frame += 4) {
+			__m128 left  = _mm_loadu_ps(input[0] + frame);
+			__m128 right = _mm_loadu_ps(input[1] + frame);
+			_mm_storeu_ps(output + frame * 2, _mm_unpacklo_ps(left, right));
+			_mm_storeu_ps(output + frame * 2 + 4, _mm_unpackhi_ps(left, right));
+		}
+#elif defined(TONPLUGINS_SIMD_NEON)
+		for (; (frame + 4) <= frames; frame += 4) {
+			float32x4x2_t pair = {{vld1q_f32(input[0] + frame), vld1q_f32(input[1] + frame)}};
+			vst2q_f32(output + frame * 2, pair);
+		}
+#endif
+	}
+	for (; frame < frames; frame++) {
+		for (size_t channel = 0; channel < channels; channel++) {
+			output[frame * channels + channel] = input[channel][frame];
+		}
+	}
+}
@@ -0,0 +1,85 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#pragma once
+#include "warning-disable.hpp"
+#include <cinttypes>
+#include <cstddef>
+#include <cstring>
+#include "warning-enable.hpp"
+
+// Shared between the reader and the writer, all values little-endian.
+namespace tonplugins::io::riff {
+
+	constexpr uint16_t format_pcm        = 0x0001;
+	constexpr uint16_t format_float      = 0x0003;
+	constexpr uint16_t format_extensible = 0xFFFE;
+
+	/// Tail of the KSDATAFORMAT_SUBTYPE GUIDs, which start with the format tag as a 32-bit value.
+	constexpr uint8_t subtype_guid[12] = {0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71};
+
+	/// Size of a "fmt " chunk body for the plain PCM, extended (with cbSize) and WAVE_FORMAT_EXTENSIBLE layouts.
+	constexpr size_t fmt_pcm_size        = 16;
+	constexpr size_t fmt_extended_size   = 18;
+	constexpr size_t fmt_extensible_size = 40;
+
+	/** Conventional speaker positions for a channel count, as used by WAVE_FORMAT_EXTENSIBLE.
+	 *
+	 * @return The channel mask, or 0 (no particular layout) for unusual counts.
+	 */
+	constexpr uint32_t channel_mask(size_t channels)
+	{
+		switch (channels) {
+		case 1:
+			return 0x4; // Center
+		case 2:
+			return 0x3; // Left, right
+		case 3:
+			return 0x7; // Left, right, center
+		case 4:
+			return 0x33; // Quad
+		case 5:
+			return 0x37; // 5.0
+		case 6:
+			return 0x3F; // 5.1
+		case 7:
+			return 0x13F; // 6.1
+		case 8:
+			return 0x63F; // 7.1
+		default:
+			return 0;
+		}
+	}
+
+	/// Size of the "ds64" chunk without its header, with an empty table.
+	constexpr size_t ds64_size = 28;
+
+	/// Sizes that don't fit 32 bits are stored as this, with the real value in "ds64".
+	constexpr uint32_t size_in_ds64 = 0xFFFFFFFF;
+
+	// Wave64 chunk identifiers, each a GUID as stored in the file.
+	constexpr uint8_t w64_riff[16] = {0x72, 0x69, 0x66, 0x66, 0x2E, 0x91, 0xCF, 0x11, 0xA5, 0xD6, 0x28, 0xDB, 0x04, 0xC1, 0x00, 0x00};
+	constexpr uint8_t w64_wave[16] = {0x77, 0x61, 0x76, 0x65, 0xF3, 0xAC, 0xD3, 0x11, 0x8C, 0xD1, 0x00, 0xC0, 0x4F, 0x8E, 0xDB, 0x8A};
+	constexpr uint8_t w64_fmt[16]  = {0x66, 0x6D, 0x74, 0x20, 0xF3, 0xAC, 0xD3, 0x11, 0x8C, 0xD1, 0x00, 0xC0, 0x4F, 0x8E, 0xDB, 0x8A};
+	constexpr uint8_t w64_fact[16] = {0x66, 0x61, 0x63, 0x74, 0xF3, 0xAC, 0xD3, 0x11, 0x8C, 0xD1, 0x00, 0xC0, 0x4F, 0x8E, 0xDB, 0x8A};
+	constexpr uint8_t w64_data[16] = {0x64, 0x61, 0x74, 0x61, 0xF3, 0xAC, 0xD3, 0x11, 0x8C, 0xD1, 0x00, 0xC0, 0x4F, 0x8E, 0xDB, 0x8A};
+
+	/// Chunk header of Wave64, a GUID and a 64-bit size that includes the header itself.
+	constexpr size_t w64_header = 24;
+
+	template<typename T>
+	T get(uint8_t const* ptr)
+	{
+		T value;
+		memcpy(&value, ptr, sizeof(T));
+		return value;
+	}
+
+	template<typename T>
+	void put(uint8_t* ptr, T value)
+	{
+		memcpy(ptr, &value, sizeof(T));
+	}
+
+} // namespace tonplugins::io::riff
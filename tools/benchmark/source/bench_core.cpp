@@ -0,0 +1,78 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#include "core.hpp"
+#include "harness.hpp"
+#include "platform.hpp"
+
+#include "warning-disable.hpp"
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "warning-enable.hpp"
+
+#if defined(_WIN32)
+constexpr char const* system_library = "kernel32.dll";
+constexpr char const* system_symbol  = "GetTickCount";
+#elif defined(__APPLE__)
+constexpr char const* system_library = "libSystem.dylib";
+constexpr char const* system_symbol  = "malloc";
+#else
+constexpr char const* system_library = "libc.so.6";
+constexpr char const* system_symbol  = "malloc";
+#endif
+
+// Splits the iterations across several threads, all running the same operation at once.
+template<typename Function>
+static void contended(uint64_t iterations, size_t threads, Function&& function)
+{
+	std::vector<std::thread> workers;
+	for (size_t idx = 0; idx < threads; idx++) {
+		workers.emplace_back([&function, count = iterations / threads + ((idx < (iterations % threads)) ? 1 : 0)]() {
+			for (uint64_t iter = 0; iter < count; iter++) {
+				function();
+			}
+		});
+	}
+	for (auto& worker : workers) {
+		worker.join();
+	}
+}
+
+void tonplugins::benchmark::register_core(harness& bench)
+{
+	for (size_t threads : {1, 4}) {
+		std::map<std::string, std::string> parameters = {{"threads", std::to_string(threads)}};
+		std::string                        suffix     = "/threads:" + std::to_string(threads);
+
+		bench.add("core::instance" + suffix, parameters, [threads](uint64_t iterations) {
+			contended(iterations, threads, []() { tonplugins::core::instance(); });
+			return uint64_t(0);
+		});
+
+		bench.add("core::log" + suffix, parameters, [threads](uint64_t iterations) {
+			auto core = tonplugins::core::instance();
+
+			// Keep the console echo out of the results, so only formatting and the log file are measured.
+			auto console = std::cout.rdbuf(nullptr);
+			contended(iterations, threads, [&core]() { core->log("Benchmark message with a number %d and a string '%s'.", 42, "text"); });
+			std::cout.rdbuf(console);
+			return uint64_t(0);
+		});
+
+		bench.add("platform::library::load" + suffix, parameters, [threads](uint64_t iterations) {
+			contended(iterations, threads, []() { tonplugins::platform::library::load(std::string_view(system_library)); });
+			return uint64_t(0);
+		});
+
+		bench.add("platform::library::load_symbol" + suffix, parameters, [threads](uint64_t iterations) {
+			auto library = tonplugins::platform::library::load(std::string_view(system_library));
+			contended(iterations, threads, [&library]() {
+				void* volatile symbol = library->load_symbol(system_symbol);
+				(void)symbol;
+			});
+			return uint64_t(0);
+		});
+	}
+}
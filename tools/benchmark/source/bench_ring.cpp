@@ -0,0 +1,194 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#include "harness.hpp"
+#include "ringbuffer.hpp"
+
+#include "warning-disable.hpp"
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <typeinfo>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+#include "warning-enable.hpp"
+
+enum class placement {
+	inline_, // Producer and consumer alternate on the same thread.
+	threads, // Separate threads, placed by the scheduler.
+	pinned, // Separate threads, pinned to different cores.
+};
+
+static char const* placement_name(placement where)
+{
+	switch (where) {
+	case placement::inline_:
+		return "inline";
+	case placement::threads:
+		return "threads";
+	case placement::pinned:
+		return "pinned";
+	}
+	return "unknown";
+}
+
+template<typename T>
+static char const* type_name()
+{
+	if constexpr (std::is_same_v<T, float>) {
+		return "float";
+	} else if constexpr (std::is_same_v<T, double>) {
+		return "double";
+	} else if constexpr (std::is_same_v<T, int16_t>) {
+		return "int16";
+	} else {
+		return typeid(T).name();
+	}
+}
+
+static void pin([[maybe_unused]] size_t core)
+{
+#if defined(__linux__)
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(static_cast<int>(core % std::thread::hardware_concurrency()), &set);
+	pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#endif
+}
+
+// Rings are created on first use and reused, so setting up the mirrored memory isn't part of the measurement.
+template<typename T>
+static std::function<tonplugins::memory::ring<T>&()> lazy_ring(size_t capacity)
+{
+	auto holder = std::make_shared<std::unique_ptr<tonplugins::memory::ring<T>>>();
+	return [holder, capacity]() -> tonplugins::memory::ring<T>& {
+		if (!*holder) {
+			*holder = std::make_unique<tonplugins::memory::ring<T>>(capacity);
+		}
+		return **holder;
+	};
+}
+
+template<typename T>
+static void register_type(tonplugins::benchmark::harness& bench)
+{
+	std::vector<placement> placements = {placement::inline_, placement::threads};
+#if defined(__linux__)
+	if (std::thread::hardware_concurrency() > 1) {
+		placements.push_back(placement::pinned);
+	}
+#endif
+
+	for (size_t capacity : {4096, 65536, 1048576}) {
+		for (size_t block : {32, 256, 4096}) {
+			if ((block * 4) > capacity) {
+				continue;
+			}
+
+			std::string suffix = std::string("<") + type_name<T>() + ">/capacity:" + std::to_string(capacity) + "/block:" + std::to_string(block);
+			std::map<std::string, std::string> parameters = {{"type", type_name<T>()}, {"capacity", std::to_string(capacity)}, {"block", std::to_string(block)}};
+
+			// Copying in and out of the ring.
+			bench.add("ring" + suffix + "/write+read", parameters, [get = lazy_ring<T>(capacity), block](uint64_t iterations) {
+				auto& ring = get();
+				std::vector<T> data(block, T(1));
+				for (uint64_t idx = 0; idx < iterations; idx++) {
+					ring.write(block, data.data());
+					ring.read(block, data.data());
+				}
+				return iterations * block * sizeof(T) * 2;
+			});
+
+			// Working in place on the mirrored memory.
+			bench.add("ring" + suffix + "/poke+peek", parameters, [get = lazy_ring<T>(capacity), block](uint64_t iterations) {
+				auto& ring = get();
+				T volatile sink = T(0);
+				for (uint64_t idx = 0; idx < iterations; idx++) {
+					T* target = ring.poke(block);
+					memset(target, 0, block * sizeof(T));
+					ring.write(block, nullptr);
+					sink = ring.peek(block)[block - 1];
+					ring.read(block, nullptr);
+				}
+				(void)sink;
+				return iterations * block * sizeof(T);
+			});
+
+			// Streaming from a producer to a consumer.
+			for (auto where : placements) {
+				auto streaming = parameters;
+				streaming["placement"] = placement_name(where);
+
+				bench.add("ring" + suffix + "/stream/" + placement_name(where), streaming, [get = lazy_ring<T>(capacity), block, where](uint64_t iterations) {
+					auto& ring = get();
+					std::vector<T> input(block, T(1));
+					std::vector<T> output(block, T(0));
+
+					// Never fill the ring completely, as a full ring looks empty.
+					auto produce = [&]() {
+						if (ring.free() <= block) {
+							return false;
+						}
+						ring.write(block, input.data());
+						return true;
+					};
+					auto consume = [&]() {
+						if (ring.used() < block) {
+							return false;
+						}
+						ring.read(block, output.data());
+						return true;
+					};
+
+					if (where == placement::inline_) {
+						for (uint64_t idx = 0; idx < iterations; idx++) {
+							produce();
+							consume();
+						}
+					} else {
+						std::thread producer([&]() {
+							if (where == placement::pinned) {
+								pin(0);
+							}
+							for (uint64_t idx = 0; idx < iterations;) {
+								if (produce()) {
+									idx++;
+								} else {
+									std::this_thread::yield();
+								}
+							}
+						});
+						std::thread consumer([&]() {
+							if (where == placement::pinned) {
+								pin(1);
+							}
+							for (uint64_t idx = 0; idx < iterations;) {
+								if (consume()) {
+									idx++;
+								} else {
+									std::this_thread::yield();
+								}
+							}
+						});
+						producer.join();
+						consumer.join();
+					}
+					return iterations * block * sizeof(T);
+				});
+			}
+		}
+	}
+}
+
+void tonplugins::benchmark::register_ring(harness& bench)
+{
+	register_type<float>(bench);
+	register_type<double>(bench);
+	register_type<int16_t>(bench);
+}
@@ -0,0 +1,143 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#include "harness.hpp"
+
+#include "warning-disable.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include "warning-enable.hpp"
+
+static std::string escape(std::string_view text)
+{
+	std::string result;
+	for (char chr : text) {
+		if ((chr == '"') || (chr == '\\')) {
+			result.push_back('\\');
+		}
+		result.push_back(chr);
+	}
+	return result;
+}
+
+tonplugins::benchmark::harness::harness(double min_time, size_t repetitions) : _min_time(min_time), _repetitions(std::max<size_t>(1, repetitions)) {}
+
+void tonplugins::benchmark::harness::add(std::string name, std::map<std::string, std::string> parameters, benchmark_t function)
+{
+	_entries.push_back({std::move(name), std::move(parameters), std::move(function)});
+}
+
+std::vector<tonplugins::benchmark::result> tonplugins::benchmark::harness::run(std::string_view filter)
+{
+	std::vector<result> results;
+
+	for (auto& entry : _entries) {
+		if (!filter.empty() && (entry.name.find(filter) == std::string::npos)) {
+			continue;
+		}
+
+		auto measure = [&entry](uint64_t iterations, uint64_t& bytes) {
+			auto start = std::chrono::steady_clock::now();
+			bytes      = entry.function(iterations);
+			return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		};
+
+		// Grow the iteration count until one run is long enough to be measured reliably.
+		uint64_t iterations = 1;
+		uint64_t bytes      = 0;
+		for (double elapsed = measure(iterations, bytes); elapsed < _min_time; elapsed = measure(iterations, bytes)) {
+			double scale = (elapsed > 0.) ? std::clamp(_min_time * 1.2 / elapsed, 2., 100.) : 100.;
+			iterations   = static_cast<uint64_t>(static_cast<double>(iterations) * scale);
+		}
+
+		std::vector<double> samples;
+		for (size_t rep = 0; rep < _repetitions; rep++) {
+			samples.push_back(measure(iterations, bytes));
+		}
+		std::sort(samples.begin(), samples.end());
+		double median = samples[samples.size() / 2];
+
+		result res;
+		res.name             = entry.name;
+		res.parameters       = entry.parameters;
+		res.iterations       = iterations;
+		res.ns_per_op        = median * 1e9 / static_cast<double>(iterations);
+		res.ns_min           = samples.front() * 1e9 / static_cast<double>(iterations);
+		res.bytes_per_second = (bytes > 0) ? (static_cast<double>(bytes) / median) : 0.;
+		results.push_back(res);
+
+		if (res.bytes_per_second > 0.) {
+			printf("%-64s %12.2f ns/op %12.2f ns/op (min) %10.2f MiB/s\n", res.name.c_str(), res.ns_per_op, res.ns_min, res.bytes_per_second / 1048576.);
+		} else {
+			printf("%-64s %12.2f ns/op %12.2f ns/op (min)\n", res.name.c_str(), res.ns_per_op, res.ns_min);
+		}
+		fflush(stdout);
+	}
+
+	return results;
+}
+
+void tonplugins::benchmark::write_json(std::filesystem::path const& file, std::vector<result> const& results)
+{
+	std::ofstream stream(file, std::ios::trunc);
+	if (!stream) {
+		throw std::runtime_error("Failed to create '" + file.string() + "'.");
+	}
+
+	stream << "{\n\t\"benchmarks\": [";
+	for (size_t idx = 0; idx < results.size(); idx++) {
+		auto const& res = results[idx];
+		stream << (idx ? ",\n" : "\n") << "\t\t{\n";
+		stream << "\t\t\t\"name\": \"" << escape(res.name) << "\",\n";
+		stream << "\t\t\t\"parameters\": {";
+		size_t count = 0;
+		for (auto const& kv : res.parameters) {
+			stream << (count++ ? ", " : "") << "\"" << escape(kv.first) << "\": \"" << escape(kv.second) << "\"";
+		}
+		stream << "},\n";
+		stream << "\t\t\t\"iterations\": " << res.iterations << ",\n";
+		stream << "\t\t\t\"ns_per_op\": " << res.ns_per_op << ",\n";
+		stream << "\t\t\t\"ns_min\": " << res.ns_min << ",\n";
+		stream << "\t\t\t\"bytes_per_second\": " << res.bytes_per_second << "\n";
+		stream << "\t\t}";
+	}
+	stream << "\n\t]\n}\n";
+}
+
+std::map<std::string, double> tonplugins::benchmark::read_baseline(std::filesystem::path const& file)
+{
+	std::ifstream stream(file);
+	if (!stream) {
+		throw std::runtime_error("Failed to open '" + file.string() + "'.");
+	}
+	std::stringstream buffer;
+	buffer << stream.rdbuf();
+	std::string text = buffer.str();
+
+	// Only needs to understand what write_json() produces: every "name" is followed by its "ns_per_op".
+	std::map<std::string, double> baseline;
+	for (size_t pos = text.find("\"name\""); pos != std::string::npos; pos = text.find("\"name\"", pos)) {
+		size_t      begin = text.find('"', text.find(':', pos) + 1) + 1;
+		size_t      end   = begin;
+		std::string name;
+		for (; (end < text.size()) && (text[end] != '"'); end++) {
+			if (text[end] == '\\') {
+				end++;
+			}
+			name.push_back(text[end]);
+		}
+
+		size_t value = text.find("\"ns_per_op\"", end);
+		if (value == std::string::npos) {
+			break;
+		}
+		baseline[name] = std::stod(text.substr(text.find(':', value) + 1));
+		pos            = value;
+	}
+	return baseline;
+}
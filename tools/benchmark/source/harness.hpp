@@ -0,0 +1,76 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#pragma once
+#include "warning-disable.hpp"
+#include <cinttypes>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "warning-enable.hpp"
+
+namespace tonplugins::benchmark {
+
+	/** Runs the given number of iterations of the operation under test.
+	 *
+	 * @return Number of bytes processed, or zero if throughput doesn't apply.
+	 */
+	typedef std::function<uint64_t(uint64_t iterations)> benchmark_t;
+
+	struct result {
+		std::string                        name;
+		std::map<std::string, std::string> parameters;
+		uint64_t                           iterations       = 0;
+		double                             ns_per_op        = 0.;
+		double                             ns_min           = 0.;
+		double                             bytes_per_second = 0.;
+	};
+
+	/** Minimal benchmark runner.
+	 *
+	 * Every benchmark is first calibrated until a single run takes at least the minimum time, then repeated a few
+	 * times. The median of the repetitions is reported, which is robust against the occasional preemption.
+	 */
+	class harness {
+		struct entry {
+			std::string                        name;
+			std::map<std::string, std::string> parameters;
+			benchmark_t                        function;
+		};
+
+		std::vector<entry> _entries;
+		double             _min_time;
+		size_t             _repetitions;
+
+		public:
+		harness(double min_time = .1, size_t repetitions = 5);
+
+		/** Add a benchmark.
+		 *
+		 * @argument name Unique name, including all parameters, used to match results against a baseline.
+		 * @argument parameters Parameters of the benchmark, for machine-readable output.
+		 * @argument function The benchmark itself.
+		 */
+		void add(std::string name, std::map<std::string, std::string> parameters, benchmark_t function);
+
+		/** Run all benchmarks whose name contains the filter.
+		 */
+		std::vector<result> run(std::string_view filter);
+	};
+
+	/** Write results as JSON.
+	 */
+	void write_json(std::filesystem::path const& file, std::vector<result> const& results);
+
+	/** Read the name and time per operation of every result in a JSON file written by write_json().
+	 */
+	std::map<std::string, double> read_baseline(std::filesystem::path const& file);
+
+	void register_ring(harness& bench);
+	void register_core(harness& bench);
+
+} // namespace tonplugins::benchmark
@@ -0,0 +1,109 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#include "core.hpp"
+#include "harness.hpp"
+
+#include "warning-disable.hpp"
+#include <cstdio>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include "warning-enable.hpp"
+
+static void usage()
+{
+	fprintf(stderr, "Usage: benchmark [options]\n"
+	                "\n"
+	                "Measures the hot paths of the core library.\n"
+	                "\n"
+	                "Options:\n"
+	                "  --filter <text>        Only run benchmarks whose name contains the text.\n"
+	                "  --min-time <seconds>   Minimum duration of a single measurement (default: 0.1).\n"
+	                "  --repetitions <count>  Number of measurements, the median is reported (default: 5).\n"
+	                "  --json <file>          Write results as JSON.\n"
+	                "  --baseline <file>      Compare against results previously written with --json.\n"
+	                "  --threshold <percent>  Slowdown against the baseline considered a regression (default: 10).\n"
+	                "\n"
+	                "Exits with code 2 if any benchmark regressed against the baseline.\n");
+}
+
+int main(int argc, char const* argv[])
+{
+	std::string           filter;
+	double                min_time    = .1;
+	size_t                repetitions = 5;
+	double                threshold   = 10.;
+	std::filesystem::path json;
+	std::filesystem::path baseline;
+
+	try {
+		for (int idx = 1; idx < argc; idx++) {
+			std::string_view arg  = argv[idx];
+			auto             next = [&]() -> std::string {
+                if ((idx + 1) >= argc) {
+                    throw std::invalid_argument("Missing value for '" + std::string(arg) + "'.");
+                }
+                return argv[++idx];
+			};
+
+			if (arg == "--filter") {
+				filter = next();
+			} else if (arg == "--min-time") {
+				min_time = std::stod(next());
+			} else if (arg == "--repetitions") {
+				repetitions = std::stoul(next());
+			} else if (arg == "--json") {
+				json = next();
+			} else if (arg == "--baseline") {
+				baseline = next();
+			} else if (arg == "--threshold") {
+				threshold = std::stod(next());
+			} else {
+				usage();
+				return 1;
+			}
+		}
+	} catch (std::exception const& ex) {
+		fprintf(stderr, "%s\n", ex.what());
+		return 1;
+	}
+
+	// Hold on to the core for the whole run, otherwise every benchmark measures its construction instead.
+	auto core = tonplugins::core::instance("Benchmark");
+
+	tonplugins::benchmark::harness bench(min_time, repetitions);
+	tonplugins::benchmark::register_ring(bench);
+	tonplugins::benchmark::register_core(bench);
+	auto results = bench.run(filter);
+
+	if (!json.empty()) {
+		tonplugins::benchmark::write_json(json, results);
+	}
+
+	if (!baseline.empty()) {
+		auto reference   = tonplugins::benchmark::read_baseline(baseline);
+		bool regressions = false;
+
+		printf("\nComparison against '%s':\n", baseline.string().c_str());
+		for (auto const& res : results) {
+			auto kv = reference.find(res.name);
+			if ((kv == reference.end()) || (kv->second <= 0.)) {
+				continue;
+			}
+
+			double change = (res.ns_per_op / kv->second - 1.) * 100.;
+			bool   slower = change > threshold;
+			regressions |= slower;
+			printf("%-64s %+8.1f %%%s\n", res.name.c_str(), change, slower ? "  REGRESSION" : "");
+		}
+
+		if (regressions) {
+			return 2;
+		}
+	}
+
+	return 0;
+}
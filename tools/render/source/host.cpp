@@ -0,0 +1,286 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#include "host.hpp"
+#include "core.hpp"
+
+#include "warning-disable.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+#include "pluginterfaces/vst/vstspeaker.h"
+#include "public.sdk/source/vst/hosting/hostclasses.h"
+#include "warning-enable.hpp"
+
+#if defined(_WIN32)
+typedef bool(PLUGIN_API* module_init_t)();
+typedef bool(PLUGIN_API* module_exit_t)();
+#else
+typedef bool(PLUGIN_API* module_init_t)(void*);
+typedef bool(PLUGIN_API* module_exit_t)();
+#endif
+typedef Steinberg::IPluginFactory*(PLUGIN_API* get_factory_t)();
+
+static std::filesystem::path resolve_binary(std::filesystem::path path)
+{
+	if (!std::filesystem::is_directory(path)) {
+		return path;
+	}
+
+	// Same layout as calculate_install_path() produces for our own modules.
+	std::filesystem::path contents = path / "Contents";
+#if defined(_WIN32)
+#if defined(_M_ARM64)
+	contents /= "arm64-win";
+#elif defined(_M_X64)
+	contents /= "x86_64-win";
+#else
+	contents /= "x86-win";
+#endif
+#elif defined(__linux__)
+#if defined(__aarch64__)
+	contents /= "aarch64-linux";
+#elif defined(__x86_64__)
+	contents /= "x86_64-linux";
+#else
+	contents /= "i386-linux";
+#endif
+#else
+	throw std::runtime_error("Loading bundles is not supported on this platform.");
+#endif
+
+	for (auto extension : {".vst3", ".so"}) {
+		std::filesystem::path binary = contents / path.stem();
+		binary += extension;
+		if (std::filesystem::exists(binary)) {
+			return binary;
+		}
+	}
+	throw std::runtime_error("Bundle '" + path.string() + "' contains no binary for this platform.");
+}
+
+tonplugins::render::module::module(std::filesystem::path path)
+{
+	_library = tonplugins::platform::library::load(resolve_binary(path));
+
+#if defined(_WIN32)
+	if (auto init = reinterpret_cast<module_init_t>(_library->load_symbol("InitDll")); init && !init()) {
+		throw std::runtime_error("InitDll failed.");
+	}
+#else
+	if (auto init = reinterpret_cast<module_init_t>(_library->load_symbol("ModuleEntry")); init && !init(_library->native_handle())) {
+		throw std::runtime_error("ModuleEntry failed.");
+	}
+#endif
+
+	auto get_factory = reinterpret_cast<get_factory_t>(_library->load_symbol("GetPluginFactory"));
+	if (!get_factory) {
+		throw std::runtime_error("Module does not export GetPluginFactory.");
+	}
+	_factory = Steinberg::owned(get_factory());
+	if (!_factory) {
+		throw std::runtime_error("Module did not return a plug-in factory.");
+	}
+
+	_host = Steinberg::owned(static_cast<Steinberg::FUnknown*>(new Steinberg::Vst::HostApplication()));
+}
+
+tonplugins::render::module::~module()
+{
+	_factory = nullptr;
+
+#if defined(_WIN32)
+	if (auto exit = reinterpret_cast<module_exit_t>(_library->load_symbol("ExitDll")); exit) {
+		exit();
+	}
+#else
+	if (auto exit = reinterpret_cast<module_exit_t>(_library->load_symbol("ModuleExit")); exit) {
+		exit();
+	}
+#endif
+}
+
+std::vector<std::string> tonplugins::render::module::effects()
+{
+	std::lock_guard<std::mutex> lock(_lock);
+
+	std::vector<std::string> result;
+	for (Steinberg::int32 idx = 0; idx < _factory->countClasses(); idx++) {
+		Steinberg::PClassInfo info;
+		if ((_factory->getClassInfo(idx, &info) == Steinberg::kResultOk) && (strcmp(info.category, kVstAudioEffectClass) == 0)) {
+			result.emplace_back(info.name);
+		}
+	}
+	return result;
+}
+
+Steinberg::IPtr<Steinberg::Vst::IComponent> tonplugins::render::module::create(std::string_view name)
+{
+	// Not every factory is safe to use from multiple threads at once.
+	std::lock_guard<std::mutex> lock(_lock);
+
+	for (Steinberg::int32 idx = 0; idx < _factory->countClasses(); idx++) {
+		Steinberg::PClassInfo info;
+		if ((_factory->getClassInfo(idx, &info) != Steinberg::kResultOk) || (strcmp(info.category, kVstAudioEffectClass) != 0)) {
+			continue;
+		}
+		if (!name.empty() && (name != info.name)) {
+			continue;
+		}
+
+		Steinberg::Vst::IComponent* component = nullptr;
+		if ((_factory->createInstance(info.cid, Steinberg::Vst::IComponent::iid, reinterpret_cast<void**>(&component)) != Steinberg::kResultOk) || !component) {
+			throw std::runtime_error("Failed to create component '" + std::string(info.name) + "'.");
+		}
+		auto result = Steinberg::owned(component);
+
+		if (result->initialize(_host) != Steinberg::kResultOk) {
+			throw std::runtime_error("Failed to initialize component '" + std::string(info.name) + "'.");
+		}
+		return result;
+	}
+
+	throw std::runtime_error(name.empty() ? std::string("Module contains no audio effects.") : ("Module contains no audio effect named '" + std::string(name) + "'."));
+}
+
+tonplugins::render::instance::instance(module& owner, std::string_view name, size_t channels, double sample_rate, size_t block) : _block(block)
+{
+	using namespace Steinberg;
+	using namespace Steinberg::Vst;
+
+	_component = owner.create(name);
+	_processor = FUnknownPtr<IAudioProcessor>(_component);
+	if (!_processor) {
+		_component->terminate();
+		throw std::runtime_error("Component is not an audio processor.");
+	}
+	if (_processor->canProcessSampleSize(kSample32) != kResultTrue) {
+		_component->terminate();
+		throw std::runtime_error("Component can't process 32-bit float audio.");
+	}
+
+	// Ask for the preferred layout on the main buses, but go with whatever the plug-in settles on.
+	{
+		int32 input_count  = _component->getBusCount(kAudio, kInput);
+		int32 output_count = _component->getBusCount(kAudio, kOutput);
+
+		std::vector<SpeakerArrangement> inputs(static_cast<size_t>(input_count), SpeakerArr::kEmpty);
+		std::vector<SpeakerArrangement> outputs(static_cast<size_t>(output_count), SpeakerArr::kEmpty);
+		for (int32 idx = 0; idx < input_count; idx++) {
+			_processor->getBusArrangement(kInput, idx, inputs[static_cast<size_t>(idx)]);
+		}
+		for (int32 idx = 0; idx < output_count; idx++) {
+			_processor->getBusArrangement(kOutput, idx, outputs[static_cast<size_t>(idx)]);
+		}
+
+		SpeakerArrangement preferred = (channels == 1) ? SpeakerArr::kMono : SpeakerArr::kStereo;
+		if (input_count > 0) {
+			inputs[0] = preferred;
+		}
+		if (output_count > 0) {
+			outputs[0] = preferred;
+		}
+		_processor->setBusArrangements(inputs.data(), input_count, outputs.data(), output_count);
+
+		if (input_count > 0) {
+			_component->activateBus(kAudio, kInput, 0, true);
+		}
+		if (output_count > 0) {
+			_component->activateBus(kAudio, kOutput, 0, true);
+		}
+	}
+
+	ProcessSetup setup;
+	setup.processMode        = kOffline;
+	setup.symbolicSampleSize = kSample32;
+	setup.maxSamplesPerBlock = static_cast<int32>(_block);
+	setup.sampleRate         = sample_rate;
+	if (_processor->setupProcessing(setup) != kResultOk) {
+		_component->terminate();
+		throw std::runtime_error("Component rejected the processing setup.");
+	}
+
+	_data.prepare(*_component, static_cast<int32>(_block), kSample32);
+	_inputs  = (_data.numInputs > 0) ? static_cast<size_t>(_data.inputs[0].numChannels) : 0;
+	_outputs = (_data.numOutputs > 0) ? static_cast<size_t>(_data.outputs[0].numChannels) : 0;
+	if (_outputs == 0) {
+		_component->terminate();
+		throw std::runtime_error("Component has no audio output.");
+	}
+
+	_context                     = {};
+	_context.state               = ProcessContext::kPlaying;
+	_context.sampleRate          = sample_rate;
+	_data.processMode            = kOffline;
+	_data.processContext         = &_context;
+	_data.inputParameterChanges  = &_input_changes;
+	_data.outputParameterChanges = &_output_changes;
+	_data.inputEvents            = &_input_events;
+	_data.outputEvents           = &_output_events;
+
+	_component->setActive(true);
+	_processor->setProcessing(true);
+	_latency = static_cast<size_t>(_processor->getLatencySamples());
+}
+
+tonplugins::render::instance::~instance()
+{
+	_processor->setProcessing(false);
+	_component->setActive(false);
+	_data.unprepare();
+	_component->terminate();
+}
+
+size_t tonplugins::render::instance::inputs() const
+{
+	return _inputs;
+}
+
+size_t tonplugins::render::instance::outputs() const
+{
+	return _outputs;
+}
+
+size_t tonplugins::render::instance::latency() const
+{
+	return _latency;
+}
+
+uint64_t tonplugins::render::instance::process(float const* const* input, size_t channels, float* const* output, size_t samples)
+{
+	samples = std::min(samples, _block);
+
+	for (size_t channel = 0; channel < _inputs; channel++) {
+		float* target = _data.inputs[0].channelBuffers32[channel];
+		if (channel < channels) {
+			memcpy(target, input[channel], samples * sizeof(float));
+		} else {
+			memset(target, 0, samples * sizeof(float));
+		}
+	}
+	for (Steinberg::int32 bus = 0; bus < _data.numInputs; bus++) {
+		_data.inputs[bus].silenceFlags = 0;
+	}
+
+	_input_changes.clearQueue();
+	_output_changes.clearQueue();
+	_input_events.clear();
+	_output_events.clear();
+	_data.numSamples = static_cast<Steinberg::int32>(samples);
+
+	auto before = std::chrono::steady_clock::now();
+	_processor->process(_data);
+	auto elapsed = std::chrono::steady_clock::now() - before;
+
+	for (size_t channel = 0; channel < _outputs; channel++) {
+		memcpy(output[channel], _data.outputs[0].channelBuffers32[channel], samples * sizeof(float));
+	}
+
+	_context.projectTimeSamples += static_cast<Steinberg::Vst::TSamples>(samples);
+	_context.continousTimeSamples += static_cast<Steinberg::Vst::TSamples>(samples);
+
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+}
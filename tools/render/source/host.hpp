@@ -0,0 +1,106 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#pragma once
+#include "platform.hpp"
+
+#include "warning-disable.hpp"
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "pluginterfaces/base/funknown.h"
+#include "pluginterfaces/base/ipluginbase.h"
+#include "pluginterfaces/base/smartpointer.h"
+#include "pluginterfaces/vst/ivstaudioprocessor.h"
+#include "pluginterfaces/vst/ivstcomponent.h"
+#include "pluginterfaces/vst/ivstprocesscontext.h"
+#include "public.sdk/source/vst/hosting/eventlist.h"
+#include "public.sdk/source/vst/hosting/parameterchanges.h"
+#include "public.sdk/source/vst/hosting/processdata.h"
+#include "warning-enable.hpp"
+
+namespace tonplugins::render {
+
+	/** A loaded VST3 module, and its plug-in factory.
+	 */
+	class module {
+		std::shared_ptr<tonplugins::platform::library> _library;
+		Steinberg::IPtr<Steinberg::IPluginFactory>     _factory;
+		Steinberg::IPtr<Steinberg::FUnknown>           _host;
+		std::mutex                                     _lock;
+
+		public:
+		/** Load a module.
+		 *
+		 * @argument path Either the .vst3 bundle directory, or the binary inside of it.
+		 */
+		module(std::filesystem::path path);
+		~module();
+
+		/** Names of all audio effect classes in the module.
+		 */
+		std::vector<std::string> effects();
+
+		/** Create and initialize an audio effect component.
+		 *
+		 * @argument name Name of the class, or empty for the first audio effect class.
+		 */
+		Steinberg::IPtr<Steinberg::Vst::IComponent> create(std::string_view name);
+	};
+
+	/** An active audio effect, set up for offline processing of 32-bit float audio.
+	 */
+	class instance {
+		Steinberg::IPtr<Steinberg::Vst::IComponent>      _component;
+		Steinberg::IPtr<Steinberg::Vst::IAudioProcessor> _processor;
+
+		Steinberg::Vst::HostProcessData  _data;
+		Steinberg::Vst::ProcessContext   _context;
+		Steinberg::Vst::ParameterChanges _input_changes;
+		Steinberg::Vst::ParameterChanges _output_changes;
+		Steinberg::Vst::EventList        _input_events;
+		Steinberg::Vst::EventList        _output_events;
+
+		size_t _inputs;
+		size_t _outputs;
+		size_t _block;
+		size_t _latency;
+
+		public:
+		/** Create a new instance.
+		 *
+		 * @argument owner Module to create the instance from.
+		 * @argument name Name of the class, or empty for the first audio effect class.
+		 * @argument channels Preferred number of input and output channels.
+		 * @argument sample_rate Sample rate to process at.
+		 * @argument block Largest number of samples per process() call.
+		 */
+		instance(module& owner, std::string_view name, size_t channels, double sample_rate, size_t block);
+		~instance();
+
+		/** Number of channels of the main input and output bus.
+		 */
+		size_t inputs() const;
+		size_t outputs() const;
+
+		/** Latency reported by the plug-in, in samples.
+		 */
+		size_t latency() const;
+
+		/** Process one block.
+		 *
+		 * @argument input inputs() channels of input, missing channels are treated as silence.
+		 * @argument channels Number of channels in input.
+		 * @argument output outputs() channels of output.
+		 * @argument samples Number of samples, at most the block size given at creation.
+		 * @return Time spent inside the plug-in, in nanoseconds.
+		 */
+		uint64_t process(float const* const* input, size_t channels, float* const* output, size_t samples);
+	};
+
+} // namespace tonplugins::render
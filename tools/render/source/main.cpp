@@ -0,0 +1,315 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#include "audio_writer.hpp"
+#include "core.hpp"
+#include "host.hpp"
+#include "stream.hpp"
+#include "synthetic.hpp"
+
+#include "warning-disable.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "warning-enable.hpp"
+
+struct options {
+	std::filesystem::path              plugin;
+	std::string                        effect;
+	size_t                             block = 512;
+	uint32_t                           rate  = 0;
+	size_t                             jobs  = 0;
+	std::filesystem::path              output;
+	std::filesystem::path              output_dir;
+	std::vector<std::filesystem::path> inputs; // Empty paths stand for synthetic audio.
+	double                             synthetic = 0.;
+	bool                               all       = false;
+	bool                               list      = false;
+};
+
+struct job {
+	std::string           effect;
+	std::filesystem::path input;
+	std::string           label;
+};
+
+struct result {
+	size_t                samples = 0;
+	uint32_t              rate    = 0;
+	double                seconds = 0.;
+	std::vector<uint64_t> blocks;
+};
+
+static void usage()
+{
+	fprintf(stderr, "Usage: render --plugin <path.vst3> [options] [--synthetic <seconds>] <input.wav>...\n"
+	                "\n"
+	                "Streams WAV, RF64 and Wave64 files through a VST3 audio effect, as fast as possible.\n"
+	                "\n"
+	                "Options:\n"
+	                "  --plugin <path>      VST3 bundle or binary to load.\n"
+	                "  --effect <name>      Audio effect class to use, defaults to the first one.\n"
+	                "  --all                Render through every audio effect class in the module.\n"
+	                "  --list               List the audio effect classes in the module and exit.\n"
+	                "  --block <samples>    Block size to process with (default: 512).\n"
+	                "  --rate <hz>          Sample rate to process at, input is resampled if needed.\n"
+	                "  --jobs <count>       Number of files to render in parallel (default: all cores).\n"
+	                "  --output <file>      Output file, only valid with a single input.\n"
+	                "  --output-dir <dir>   Directory to write outputs into, named after their input.\n"
+	                "  --synthetic <secs>   Also render built-in stereo test audio of the given length, for example to\n"
+	                "                       collect profiles for profile-guided optimization.\n"
+	                "\n"
+	                "Without --output or --output-dir the rendered audio is discarded, which is useful for profiling.\n");
+}
+
+static bool parse(int argc, char const* const* argv, options& opts)
+{
+	for (int idx = 1; idx < argc; idx++) {
+		std::string_view arg = argv[idx];
+		auto             next = [&]() -> std::string_view {
+            if ((idx + 1) >= argc) {
+                throw std::invalid_argument("Missing value for '" + std::string(arg) + "'.");
+            }
+            return argv[++idx];
+		};
+
+		if (arg == "--plugin") {
+			opts.plugin = next();
+		} else if (arg == "--effect") {
+			opts.effect = next();
+		} else if (arg == "--all") {
+			opts.all = true;
+		} else if (arg == "--list") {
+			opts.list = true;
+		} else if (arg == "--block") {
+			opts.block = std::stoul(std::string(next()));
+		} else if (arg == "--rate") {
+			opts.rate = static_cast<uint32_t>(std::stoul(std::string(next())));
+		} else if (arg == "--jobs") {
+			opts.jobs = std::stoul(std::string(next()));
+		} else if (arg == "--output") {
+			opts.output = next();
+		} else if (arg == "--output-dir") {
+			opts.output_dir = next();
+		} else if (arg == "--synthetic") {
+			opts.synthetic = std::stod(std::string(next()));
+			if (!(opts.synthetic > 0.)) {
+				throw std::invalid_argument("Synthetic audio must be longer than zero seconds.");
+			}
+			opts.inputs.emplace_back();
+		} else if ((arg == "--help") || (arg == "-h")) {
+			return false;
+		} else if (arg.starts_with("--")) {
+			throw std::invalid_argument("Unknown option '" + std::string(arg) + "'.");
+		} else {
+			opts.inputs.emplace_back(arg);
+		}
+	}
+
+	if (opts.plugin.empty() || (!opts.list && opts.inputs.empty())) {
+		return false;
+	}
+	if (opts.block == 0) {
+		throw std::invalid_argument("Block size must be non-zero.");
+	}
+	if (!opts.output.empty() && ((opts.inputs.size() != 1) || opts.all)) {
+		throw std::invalid_argument("--output can only be used with a single input and effect, use --output-dir instead.");
+	}
+	if (opts.jobs == 0) {
+		opts.jobs = std::max<size_t>(1, std::thread::hardware_concurrency());
+	}
+	return true;
+}
+
+static result render(tonplugins::render::module& plugin, options const& opts, job const& work)
+{
+	std::unique_ptr<tonplugins::render::stream> input;
+	if (work.input.empty()) {
+		input = std::make_unique<tonplugins::render::stream>(tonplugins::render::synthesize((opts.rate != 0) ? opts.rate : 48000, 2, opts.synthetic), opts.rate);
+	} else {
+		input = std::make_unique<tonplugins::render::stream>(work.input, opts.rate);
+	}
+
+	tonplugins::render::instance effect(plugin, work.effect, input->channels(), static_cast<double>(input->sample_rate()), opts.block);
+
+	result res;
+	res.samples = static_cast<size_t>(input->frames());
+	res.rate    = input->sample_rate();
+
+	// Render an extra latency() samples, and drop that many from the front, so output lines up with input.
+	size_t latency = effect.latency();
+	size_t total   = res.samples + latency;
+	res.blocks.reserve((total + opts.block - 1) / opts.block);
+
+	// Both ends are streamed one block at a time, so memory use doesn't depend on the length of the input.
+	std::filesystem::path target = opts.output;
+	if (!opts.output_dir.empty()) {
+		target = opts.output_dir / work.label;
+	}
+	std::unique_ptr<tonplugins::io::audio_writer> writer;
+	if (!target.empty()) {
+		writer = std::make_unique<tonplugins::io::audio_writer>(target, tonplugins::io::audio_format{tonplugins::io::container::wav, tonplugins::io::sample_format::float32, static_cast<uint16_t>(effect.outputs()), res.rate});
+	}
+
+	std::vector<std::vector<float>> inputs(input->channels(), std::vector<float>(opts.block, 0.f));
+	std::vector<std::vector<float>> outputs(effect.outputs(), std::vector<float>(opts.block, 0.f));
+	std::vector<float*>             sources;
+	std::vector<float*>             targets;
+	std::vector<float const*>       written(outputs.size(), nullptr);
+	for (auto& channel : inputs) {
+		sources.push_back(channel.data());
+	}
+	for (auto& channel : outputs) {
+		targets.push_back(channel.data());
+	}
+
+	std::chrono::steady_clock::duration elapsed{0};
+	for (size_t offset = 0; offset < total; offset += opts.block) {
+		size_t length = std::min(opts.block, total - offset);
+		input->read(sources.data(), length);
+
+		// Only the processing itself is timed, reading and writing files is not what is being measured.
+		auto start = std::chrono::steady_clock::now();
+		res.blocks.push_back(effect.process(sources.data(), sources.size(), targets.data(), length));
+		elapsed += std::chrono::steady_clock::now() - start;
+
+		if (writer) {
+			size_t skip = (offset < latency) ? std::min(latency - offset, length) : 0;
+			for (size_t channel = 0; channel < written.size(); channel++) {
+				written[channel] = targets[channel] + skip;
+			}
+			writer->write(written.data(), length - skip);
+		}
+	}
+	res.seconds = std::chrono::duration<double>(elapsed).count();
+
+	if (writer) {
+		writer->close();
+	}
+
+	return res;
+}
+
+static double percentile(std::vector<uint64_t> const& sorted, double fraction)
+{
+	if (sorted.empty()) {
+		return 0.;
+	}
+	size_t index = static_cast<size_t>(std::ceil(fraction * static_cast<double>(sorted.size()))) - 1;
+	return static_cast<double>(sorted[std::min(index, sorted.size() - 1)]) / 1000.;
+}
+
+static void report(std::string const& label, result& res, size_t block)
+{
+	std::sort(res.blocks.begin(), res.blocks.end());
+
+	double duration = static_cast<double>(res.samples) / static_cast<double>(res.rate);
+	double rtf      = (duration > 0.) ? (res.seconds / duration) : 0.;
+	double budget   = static_cast<double>(block) / static_cast<double>(res.rate) * 1000000.;
+
+	printf("%s: %.2f s at %" PRIu32 " Hz in %.3f s, RTF %.4f (%.1fx real-time), block p50 %.1f us, p90 %.1f us, p99 %.1f us, max %.1f us (budget %.1f us)\n", label.c_str(), duration, res.rate, res.seconds, rtf, (rtf > 0.) ? (1. / rtf) : 0., percentile(res.blocks, .5), percentile(res.blocks, .9), percentile(res.blocks, .99), percentile(res.blocks, 1.), budget);
+}
+
+int main(int argc, char const* argv[])
+{
+	options opts;
+	try {
+		if (!parse(argc, argv, opts)) {
+			usage();
+			return 1;
+		}
+	} catch (std::exception const& ex) {
+		fprintf(stderr, "%s\n", ex.what());
+		return 1;
+	}
+
+	// Keep the shared state (logging, caches) alive for the whole run.
+	auto core = tonplugins::core::instance("Render");
+
+	std::shared_ptr<tonplugins::render::module> plugin;
+	try {
+		plugin = std::make_shared<tonplugins::render::module>(opts.plugin);
+	} catch (std::exception const& ex) {
+		fprintf(stderr, "Failed to load '%s': %s\n", opts.plugin.string().c_str(), ex.what());
+		return 1;
+	}
+
+	if (opts.list) {
+		for (auto const& name : plugin->effects()) {
+			printf("%s\n", name.c_str());
+		}
+		return 0;
+	}
+
+	if (!opts.output_dir.empty()) {
+		std::filesystem::create_directories(opts.output_dir);
+	}
+
+	// Every input is rendered through every selected effect.
+	std::vector<std::string> effects = {opts.effect};
+	if (opts.all) {
+		effects = plugin->effects();
+	}
+	std::vector<job> jobs;
+	for (auto const& effect : effects) {
+		for (auto const& input : opts.inputs) {
+			std::string label = input.empty() ? "synthetic.wav" : input.filename().string();
+			if (effects.size() > 1) {
+				label = effect + " - " + label;
+			}
+			jobs.push_back({effect, input, label});
+		}
+	}
+
+	// Every worker takes the next file until none are left.
+	std::atomic_size_t next     = 0;
+	std::atomic_size_t failures = 0;
+	std::mutex         print_lock;
+	double             audio_seconds = 0.;
+
+	auto start  = std::chrono::steady_clock::now();
+	auto worker = [&]() {
+		for (size_t idx = next.fetch_add(1); idx < jobs.size(); idx = next.fetch_add(1)) {
+			auto const& work = jobs[idx];
+			try {
+				result                      res = render(*plugin, opts, work);
+				std::lock_guard<std::mutex> lock(print_lock);
+				audio_seconds += static_cast<double>(res.samples) / static_cast<double>(res.rate);
+				report(work.label, res, opts.block);
+			} catch (std::exception const& ex) {
+				std::lock_guard<std::mutex> lock(print_lock);
+				fprintf(stderr, "%s: %s\n", work.label.c_str(), ex.what());
+				failures.fetch_add(1);
+			}
+		}
+	};
+
+	std::vector<std::thread> workers;
+	for (size_t idx = 1; idx < std::min(opts.jobs, jobs.size()); idx++) {
+		workers.emplace_back(worker);
+	}
+	worker();
+	for (auto& thread : workers) {
+		thread.join();
+	}
+
+	if (jobs.size() > 1) {
+		double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		printf("Total: %zu files, %.2f s of audio in %.3f s (%.1fx real-time), %zu failed\n", jobs.size(), audio_seconds, elapsed, (elapsed > 0.) ? (audio_seconds / elapsed) : 0., failures.load());
+	}
+
+	return (failures.load() > 0) ? 1 : 0;
+}
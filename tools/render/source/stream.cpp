@@ -0,0 +1,144 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#include "stream.hpp"
+
+#include "warning-disable.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include "warning-enable.hpp"
+
+tonplugins::render::stream::stream(std::filesystem::path const& file, uint32_t rate) : _memory_position(0), _channels(0), _sample_rate(0), _frames(0), _position(0), _skip(0), _padding(0), _available(0), _consumed(0)
+{
+	_reader   = std::make_unique<tonplugins::io::audio_reader>(file);
+	_channels = _reader->channels();
+	initialize(_reader->sample_rate(), _reader->frames(), rate);
+}
+
+tonplugins::render::stream::stream(tonplugins::io::audio audio, uint32_t rate) : _memory(std::move(audio)), _memory_position(0), _channels(0), _sample_rate(0), _frames(0), _position(0), _skip(0), _padding(0), _available(0), _consumed(0)
+{
+	if (_memory.channels.empty() || (_memory.sample_rate == 0)) {
+		throw std::invalid_argument("Audio needs at least one channel and a non-zero sample rate.");
+	}
+	_channels = _memory.channels.size();
+	initialize(_memory.sample_rate, _memory.samples(), rate);
+}
+
+size_t tonplugins::render::stream::channels() const
+{
+	return _channels;
+}
+
+uint32_t tonplugins::render::stream::sample_rate() const
+{
+	return _sample_rate;
+}
+
+uint64_t tonplugins::render::stream::frames() const
+{
+	return _frames;
+}
+
+void tonplugins::render::stream::read(float* const* output, size_t frames)
+{
+	size_t wanted = static_cast<size_t>(std::min<uint64_t>(frames, _frames - _position));
+	auto&  ready  = _resampler ? _converted : _input;
+
+	size_t done = 0;
+	while (done < wanted) {
+		if (_consumed == _available) {
+			if (refill() == 0) {
+				break;
+			}
+			continue;
+		}
+
+		size_t length = std::min(wanted - done, _available - _consumed);
+		for (size_t channel = 0; channel < _channels; channel++) {
+			std::copy_n(ready[channel].data() + _consumed, length, output[channel] + done);
+		}
+		_consumed += length;
+		done += length;
+	}
+	_position += done;
+
+	// Past the end, and where the resampler came up short, there is only silence.
+	for (size_t channel = 0; channel < _channels; channel++) {
+		std::fill(output[channel] + done, output[channel] + frames, 0.f);
+	}
+}
+
+void tonplugins::render::stream::initialize(uint32_t input_rate, uint64_t input_frames, uint32_t rate)
+{
+	_sample_rate = (rate != 0) ? rate : input_rate;
+	_frames      = input_frames;
+	_input.resize(_channels, std::vector<float>(chunk_frames, 0.f));
+	_sources.resize(_channels, nullptr);
+	_targets.resize(_channels, nullptr);
+
+	if (_sample_rate != input_rate) {
+		_resampler = std::make_unique<tonplugins::dsp::resampler<float>>(_channels, input_rate, _sample_rate, tonplugins::dsp::resampler<float>::quality::high);
+
+		// Flush the filter with silence at the end, and drop its delay from the front, so the timing is preserved.
+		_skip    = static_cast<size_t>(std::lround(_resampler->latency()));
+		_padding = static_cast<size_t>(std::ceil(_resampler->input_latency())) + 1;
+		_frames  = (input_frames * _sample_rate) / input_rate;
+		_converted.resize(_channels, std::vector<float>(_resampler->maximum_output(chunk_frames), 0.f));
+	}
+}
+
+size_t tonplugins::render::stream::pull(size_t frames)
+{
+	for (size_t channel = 0; channel < _channels; channel++) {
+		_targets[channel] = _input[channel].data();
+	}
+
+	if (_reader) {
+		return _reader->read(_targets.data(), frames);
+	}
+
+	size_t length = static_cast<size_t>(std::min<uint64_t>(frames, _memory.samples() - _memory_position));
+	for (size_t channel = 0; channel < _channels; channel++) {
+		std::copy_n(_memory.channels[channel].data() + _memory_position, length, _targets[channel]);
+	}
+	_memory_position += length;
+	return length;
+}
+
+size_t tonplugins::render::stream::refill()
+{
+	size_t length = pull(chunk_frames);
+	if (!_resampler) {
+		_available = length;
+		_consumed  = 0;
+		return length;
+	}
+
+	if ((length < chunk_frames) && (_padding > 0)) {
+		size_t padding = std::min(_padding, chunk_frames - length);
+		for (size_t channel = 0; channel < _channels; channel++) {
+			std::fill_n(_input[channel].data() + length, padding, 0.f);
+		}
+		length += padding;
+		_padding -= padding;
+	}
+	if (length == 0) {
+		return 0;
+	}
+
+	for (size_t channel = 0; channel < _channels; channel++) {
+		_sources[channel] = _input[channel].data();
+		_targets[channel] = _converted[channel].data();
+	}
+	size_t produced = _resampler->process(_sources.data(), length, _targets.data());
+
+	size_t dropped = std::min(_skip, produced);
+	_skip -= dropped;
+	_available = produced;
+	_consumed  = dropped;
+
+	// Report what was fed rather than produced, as the delay may swallow a whole chunk without reaching the end.
+	return length;
+}
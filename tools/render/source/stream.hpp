@@ -0,0 +1,82 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#pragma once
+#include "audio_reader.hpp"
+#include "resampler.hpp"
+
+#include "warning-disable.hpp"
+#include <cinttypes>
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <vector>
+#include "warning-enable.hpp"
+
+namespace tonplugins::render {
+
+	/** Input audio delivered block by block, optionally converted to another sample rate on the fly.
+	 *
+	 * Files are streamed with io::audio_reader, so only a few chunks are ever held in memory regardless of their length.
+	 */
+	class stream {
+		public:
+		/// Frames read from the source at once.
+		static constexpr size_t chunk_frames = 4096;
+
+		private:
+		std::unique_ptr<tonplugins::io::audio_reader> _reader;
+		tonplugins::io::audio                         _memory; // Used instead of a reader for generated audio.
+		uint64_t                                      _memory_position;
+		size_t                                        _channels;
+		uint32_t                                      _sample_rate;
+		uint64_t                                      _frames;
+		uint64_t                                      _position;
+
+		std::unique_ptr<tonplugins::dsp::resampler<float>> _resampler;
+		size_t                                             _skip;    // Output frames still to drop for the resampler's delay.
+		size_t                                             _padding; // Frames of silence still to flush the resampler with.
+
+		std::vector<std::vector<float>> _input;
+		std::vector<std::vector<float>> _converted;
+		std::vector<float const*>       _sources;
+		std::vector<float*>             _targets;
+		size_t                          _available; // Frames in _converted.
+		size_t                          _consumed;  // Frames in _converted that were already handed out.
+
+		public:
+		/** Stream a file.
+		 *
+		 * @argument file Any file io::audio_reader supports.
+		 * @argument rate Sample rate to deliver, or 0 to keep the file's own.
+		 */
+		stream(std::filesystem::path const& file, uint32_t rate);
+
+		/** Stream audio that is already in memory.
+		 *
+		 * @argument rate Sample rate to deliver, or 0 to keep the audio's own.
+		 */
+		stream(tonplugins::io::audio audio, uint32_t rate);
+
+		size_t   channels() const;
+		uint32_t sample_rate() const;
+
+		/** Length in frames at sample_rate().
+		 */
+		uint64_t frames() const;
+
+		/** Deliver the next frames, followed by silence once the end has been reached.
+		 *
+		 * @argument output Pointers to each channel, at least channels() of them.
+		 * @argument frames Number of frames to deliver.
+		 */
+		void read(float* const* output, size_t frames);
+
+		private:
+		void   initialize(uint32_t input_rate, uint64_t input_frames, uint32_t rate);
+		size_t pull(size_t frames);
+		size_t refill();
+	};
+
+} // namespace tonplugins::render
@@ -0,0 +1,93 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#include "synthetic.hpp"
+
+#include "warning-disable.hpp"
+#include <cmath>
+#include <numbers>
+#include <stdexcept>
+#include "warning-enable.hpp"
+
+// Length of each section of the signal, in seconds.
+constexpr double section_length = 4.;
+
+enum class section {
+	speech,
+	sweep,
+	bursts,
+	quiet,
+	silence,
+	_count,
+};
+
+tonplugins::io::audio tonplugins::render::synthesize(uint32_t sample_rate, size_t channels, double seconds)
+{
+	if ((sample_rate == 0) || (channels == 0) || !(seconds > 0.)) {
+		throw std::invalid_argument("Synthetic audio needs a sample rate, channels and a length.");
+	}
+
+	double const rate    = static_cast<double>(sample_rate);
+	size_t const samples = static_cast<size_t>(seconds * rate);
+
+	tonplugins::io::audio output;
+	output.sample_rate = sample_rate;
+	output.channels.resize(channels, std::vector<float>(samples, 0.f));
+
+	for (size_t channel = 0; channel < channels; channel++) {
+		float*   data   = output.channels[channel].data();
+		double   offset = static_cast<double>(channel) * .37; // Decorrelate channels a little.
+		uint32_t noise  = 0x9E3779B9u * static_cast<uint32_t>(channel + 1);
+		double   phase  = 0.;
+
+		for (size_t idx = 0; idx < samples; idx++) {
+			double time  = static_cast<double>(idx) / rate;
+			auto   kind  = static_cast<section>(static_cast<size_t>(time / section_length) % static_cast<size_t>(section::_count));
+			double local = std::fmod(time, section_length);
+
+			noise        = noise * 1664525u + 1013904223u;
+			double white = static_cast<double>(noise) / 2147483648. - 1.;
+
+			double value = 0.;
+			switch (kind) {
+			case section::speech: {
+				// Harmonics of a gliding fundamental, shaped into syllables.
+				double f0 = 120. + 30. * std::sin(2. * std::numbers::pi * (.7 * time + offset));
+				phase     = std::fmod(phase + f0 / rate, 1.);
+				double h  = 0.;
+				for (size_t k = 1; (k <= 12) && ((static_cast<double>(k) * f0) < (rate * .45)); k++) {
+					h += std::sin(2. * std::numbers::pi * phase * static_cast<double>(k)) / static_cast<double>(k);
+				}
+				double syllable = std::pow(.5 + .5 * std::sin(2. * std::numbers::pi * (4. * time + offset)), 2.);
+				value           = .3 * syllable * h + .01 * white;
+				break;
+			}
+			case section::sweep: {
+				// Logarithmic sweep from 20 Hz to just below Nyquist.
+				double f1 = 20.;
+				double f2 = rate * .45;
+				double k  = std::log(f2 / f1) / section_length;
+				value     = .5 * std::sin(2. * std::numbers::pi * f1 * (std::exp(k * local) - 1.) / k + offset);
+				break;
+			}
+			case section::bursts: {
+				// Sharp attacks with exponential decay, four per second.
+				double since = std::fmod(local + offset * .1, .25);
+				value        = .8 * white * std::exp(-since * 40.);
+				break;
+			}
+			case section::quiet:
+				// Around -100 dBFS, where recursive filters tend to run into denormals.
+				value = 1e-5 * white;
+				break;
+			default:
+				break;
+			}
+
+			data[idx] = static_cast<float>(value);
+		}
+	}
+
+	return output;
+}
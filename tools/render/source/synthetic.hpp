@@ -0,0 +1,27 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2024 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#pragma once
+#include "audio_reader.hpp"
+
+#include "warning-disable.hpp"
+#include <cinttypes>
+#include <cstddef>
+#include "warning-enable.hpp"
+
+namespace tonplugins::render {
+
+	/** Generate a deterministic test signal that exercises typical processing paths.
+	 *
+	 * Cycles through speech-like modulated harmonics, a logarithmic sine sweep, noise bursts with sharp transients,
+	 * near-silence and true digital silence, so that profiles cover gates, detectors and denormal handling as well as
+	 * steady-state processing.
+	 *
+	 * @argument sample_rate Sample rate of the signal.
+	 * @argument channels Number of channels, each with a slightly different signal.
+	 * @argument seconds Length of the signal.
+	 */
+	tonplugins::io::audio synthesize(uint32_t sample_rate, size_t channels, double seconds);
+
+} // namespace tonplugins::render